@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// MAVLink sequence tracking for one source (sysid, compid); the telemetry
+// source table keeps one per sender.
+//
+// Each sender numbers its frames with an 8-bit seq. A jump ahead counts the
+// skipped frames as lost; a frame at or behind the expected seq is a
+// duplicate if it was already seen (32-frame history) or a late, reordered
+// frame otherwise, in which case it is taken back off the lost count.
+
+#ifndef LINK_QUALITY_WINDOW
+// Loss is estimated over roughly the last this-many expected frames: the
+// window counters are halved whenever they reach it.
+#define LINK_QUALITY_WINDOW 256u
+#endif
+
+typedef struct LinkQuality
+{
+    uint8_t next_seq;                   // expected seq of the next frame
+    uint32_t history;                   // bit i: frame (next_seq - 1 - i) seen
+
+    // Since first seen
+    uint32_t received;                  // unique frames
+    uint32_t lost;
+    uint32_t duplicated;
+    uint32_t reordered;
+
+    // Decaying window for the loss estimate
+    uint16_t win_received;
+    uint16_t win_lost;
+} LinkQuality;
+
+void LinkQuality_Init(LinkQuality* self);
+void LinkQuality_OnFrame(LinkQuality* self, uint8_t seq);
+
+// Loss over the window in 0.1 % units; 0 until any frame was expected.
+uint16_t LinkQuality_LossPermille(const LinkQuality* self);
+
+// Frames the current window is based on (received + lost).
+uint32_t LinkQuality_WindowFrames(const LinkQuality* self);
+
+#ifdef __cplusplus
+}
+#endif
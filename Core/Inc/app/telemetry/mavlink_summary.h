@@ -1,13 +1,22 @@
 #pragma once
 
 #include <stdint.h>
-#include "mavlink/common/mavlink.h"
+#include "mavlink_lib.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#define MAV_SUM_MSGID_MAX 256u
+#ifndef MAV_SUM_MSGID_SLOTS
+// Distinct msgids counted per window (power of two, 6 bytes each). The
+// hash is filled to 7/8 at most; further new msgids in the window are only
+// counted in win_msgid_dropped (logged as drop=; top-3 may then miss them).
+#define MAV_SUM_MSGID_SLOTS 64u
+#endif
+
+#if ((MAV_SUM_MSGID_SLOTS & (MAV_SUM_MSGID_SLOTS - 1u)) != 0u) || (MAV_SUM_MSGID_SLOTS < 8u)
+#error "MAV_SUM_MSGID_SLOTS must be a power of two >= 8"
+#endif
 
 struct TelemetryState;
 
@@ -22,7 +31,7 @@ typedef struct MavlinkSummary
     uint32_t win_hb;
 
     // Last seen message (for quick insight)
-    uint8_t last_msgid;
+    uint32_t last_msgid;
     uint8_t last_sysid;
     uint8_t last_compid;
 
@@ -30,7 +39,12 @@ typedef struct MavlinkSummary
     uint32_t last_log_ms;
     uint32_t period_ms;
 
-    uint16_t win_msgid_counts[MAV_SUM_MSGID_MAX];
+    // Per-msgid counts for the window: open-addressing hash keyed by the
+    // full 24-bit msgid. A slot is free while its count is 0.
+    uint32_t win_msgid_ids[MAV_SUM_MSGID_SLOTS];
+    uint16_t win_msgid_counts[MAV_SUM_MSGID_SLOTS];
+    uint16_t win_msgid_used;
+    uint32_t win_msgid_dropped;
 
 	// Important message counters (window)
 	uint16_t win_sys_status;
@@ -41,6 +55,7 @@ typedef struct MavlinkSummary
 
 void MavlinkSummary_Init(MavlinkSummary* self, uint32_t period_ms);
 void MavlinkSummary_OnMessage(MavlinkSummary* self, const mavlink_message_t* msg);
+// tlm supplies the vehicle fields of the line (NULL: not available yet).
 void MavlinkSummary_UpdateAndLog(MavlinkSummary* self, uint32_t now_ms, const struct TelemetryState* tlm);
 
 #ifdef __cplusplus
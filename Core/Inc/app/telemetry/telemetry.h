@@ -2,12 +2,31 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "mavlink/common/mavlink.h"
+#include "mavlink_lib.h"
+#include "app/telemetry/link_quality.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifndef TELEMETRY_MAX_SOURCES
+// Senders (sysid, compid) tracked at once. A new sender beyond this
+// replaces the one heard from least recently.
+#define TELEMETRY_MAX_SOURCES 8u
+#endif
+
+#ifndef TELEMETRY_INDEX_SIZE
+// Open-addressing slots for the (sysid, compid) lookup: a power of two, at
+// least twice TELEMETRY_MAX_SOURCES to keep probe runs short.
+#define TELEMETRY_INDEX_SIZE 16u
+#endif
+
+#if ((TELEMETRY_INDEX_SIZE & (TELEMETRY_INDEX_SIZE - 1u)) != 0u) || \
+    (TELEMETRY_INDEX_SIZE < (2u * TELEMETRY_MAX_SOURCES)) || (TELEMETRY_MAX_SOURCES > 255u)
+#error "TELEMETRY_INDEX_SIZE must be a power of two >= 2 * TELEMETRY_MAX_SOURCES (max 255 sources)"
+#endif
+
+// Last known state of one sender
 typedef struct TelemetryState
 {
     uint8_t sysid;
@@ -29,14 +48,47 @@ typedef struct TelemetryState
     uint32_t last_msg_ms;
     uint32_t msg_count;
 
+    // Sequence gaps (loss / duplicates / reordering)
+    LinkQuality link;
+
 } TelemetryState;
 
+// Payload decoder for one msgid. Does not count the message.
+typedef void (*Telemetry_MsgHandlerFn)(const mavlink_message_t* msg, uint32_t now_ms);
+
+typedef struct
+{
+    uint32_t msgid;
+    Telemetry_MsgHandlerFn fn;
+} TelemetryMsgHandler;
+
 void Telemetry_Init(void);
+
+// Count and decode one message (for callers without a per-msgid dispatcher).
 void Telemetry_OnMavlink(const mavlink_message_t* msg, uint32_t now_ms);
+
+// Count a message from its header fields only; the payload is not used.
+// validated = false (frame not CRC-checked, see MavlinkRx_IsValidated())
+// never adds or evicts a source: the header may be noise.
+void Telemetry_OnMavlinkHeader(const mavlink_message_t* msg, uint32_t now_ms, bool validated);
+
+// Per-msgid decoders, to be registered with a dispatcher (e.g.
+// MavlinkRx_Subscribe()) alongside Telemetry_OnMavlinkHeader() for every message.
+uint32_t Telemetry_GetMsgHandlers(const TelemetryMsgHandler** out_handlers);
 void Telemetry_Update(uint32_t now_ms);
 
-// Read-only access to the current state (no ownership transfer).
-const TelemetryState* Telemetry_Get(void);
+// Read-only access to the source table (no ownership transfer). Indices run
+// 0..count-1; a slot is reused in place when its source is evicted.
+uint32_t Telemetry_GetSourceCount(void);
+const TelemetryState* Telemetry_GetSource(uint32_t index);
+const TelemetryState* Telemetry_Find(uint8_t sysid, uint8_t compid);
+
+// Source that sent the most messages (normally the vehicle's autopilot), or
+// NULL before the first message.
+const TelemetryState* Telemetry_GetPrimary(void);
+
+// Sources dropped to make room for a new one.
+uint32_t Telemetry_GetEvictions(void);
 
 #ifdef __cplusplus
 }
@@ -2,6 +2,16 @@
 
 #include "mavlink_rx.h"
 
+#ifndef APP_TEST_SPSC_STRESS
+// 1: build AppTest_UartRxRing_SpscStressOnce(). It takes over TIM2 and
+//    its interrupt vector, so keep it off in product builds.
+#define APP_TEST_SPSC_STRESS 0
+#endif
+
+#if APP_TEST_SPSC_STRESS && (!UART_RX_RING_SPSC || UART_RX_RING_DIRECT_DMA || UART_RX_RING_PINGPONG_DMA)
+#error "APP_TEST_SPSC_STRESS needs UART_RX_RING_SPSC=1 with polling or IDLE DMA"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -17,6 +27,46 @@ void AppTests_Update(void);
 // Specific tests:
 void AppTest_MavlinkRx_LogRxStatsOncePerSecond(const MavlinkRx* mav_rx);
 
+// Parser counters of the last second (see MavlinkRx_Stats).
+void AppTest_MavlinkRx_LogParserStatsOncePerSecond(MavlinkRx* mav_rx);
+#if UART_RX_RING_HISTOGRAMS
+void AppTest_MavlinkRx_LogRxHistogramsOncePerSecond(MavlinkRx* mav_rx);
+#endif
+
+// One-shot X.25 CRC benchmark (DWT cycle counter): bitwise baseline vs
+// the configured MAVLINK_CRC_IMPL, per byte and per buffer.
+void AppTest_MavlinkCrc_BenchmarkOnce(void);
+
+// One-shot check of the generated msg entry index against MAVLINK_MESSAGE_CRCS
+// (full or trimmed), with lookup cycles against the library's bisection.
+void AppTest_MavlinkMsgEntry_VerifyOnce(void);
+
+// One-shot signature verification benchmark (DWT cycle counter): cycles per
+// signed frame through MavlinkSign_Check() for several payload sizes, and
+// the CPU share that costs at 500 frames/s.
+void AppTest_MavlinkSign_BenchmarkOnce(void);
+
+// One-shot differential check: a generated frame stream (v1/v2, bit flips,
+// truncation, bad len/flags, STX-heavy payloads and noise) through
+// mavlink_parse_char() and MavlinkRx_ParseSpan() in random spans; every
+// frame must be delivered by both, with the same content. Runs unsigned,
+// then with the same signing key on both sides (signed frames also get bad
+// CRC and signature bytes) and checks signatures bit for bit.
+void AppTest_MavlinkRx_DiffParseCharOnce(void);
+
+#if MAVLINK_RX_RESYNC
+// One-shot noise injection: the same corrupted frame stream (dropped runs
+// and flipped bytes) through two parsers, without and with lookback resync.
+void AppTest_MavlinkRx_ResyncNoiseOnce(void);
+#endif
+
+#if APP_TEST_SPSC_STRESS
+// One-shot SPSC stress (~2 s, blocking): a TIM2 interrupt pushes an LCG
+// byte stream through a test ring (fake DMA + PollFromDma()) while the main
+// loop reads it back with Peek()/Commit() and Read(); every byte is checked.
+void AppTest_UartRxRing_SpscStressOnce(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
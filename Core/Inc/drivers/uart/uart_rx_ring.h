@@ -13,46 +13,200 @@ extern "C" {
 // Data flow:
 //   DMA writes into dma_buf[] (circular)
 //   We periodically call UartRxRing_PollFromDma() to move new bytes into sw ring
+//   (or, with UART_RX_RING_IDLE_DMA, the HAL RX event callback does it on
+//   IDLE line / DMA half / DMA full, see UartRxRing_OnRxEvent())
 //   Consumer reads from sw ring via UartRxRing_Read()
+//   (or in place via UartRxRing_Peek() + UartRxRing_Commit(), no extra copy)
 
+// Default buffer sizes used by UartRxRing_Init(). Rings created with
+// UartRxRing_InitWithBuffers() choose their own sizes at runtime.
 #ifndef UART_RX_RING_DMA_BUF_SIZE
 #define UART_RX_RING_DMA_BUF_SIZE 256u
 #endif
 
+// Must be a power of two (index wraparound is done with a mask).
 #ifndef UART_RX_RING_SW_BUF_SIZE
 #define UART_RX_RING_SW_BUF_SIZE 512u
 #endif
 
+// Lock-free single-producer/single-consumer mode.
+// 0: SW ring indices and stats are protected by masking IRQs (default).
+// 1: no IRQ masking; exactly one context may call UartRxRing_PollFromDma()
+//    (producer, e.g. an ISR) and exactly one other context may call
+//    UartRxRing_Read()/Peek()/Commit()/Available() (consumer, e.g. main loop).
+//    Stats fields are then read individually, not as an atomic snapshot.
+#ifndef UART_RX_RING_SPSC
+#define UART_RX_RING_SPSC 0
+#endif
+
+// Event-driven ingestion.
+// 0: bytes move only when UartRxRing_PollFromDma() is called (default).
+// 1: reception uses HAL_UARTEx_ReceiveToIdle_DMA() and bytes move from
+//    HAL_UARTEx_RxEventCallback() (ISR context) at the end of each burst and
+//    at every DMA half/full wrap. UartRxRing_PollFromDma() must then not be
+//    called for the same ring (the callback is the only producer).
+#ifndef UART_RX_RING_IDLE_DMA
+#define UART_RX_RING_IDLE_DMA 0
+#endif
+
+// Ping-pong (double-buffer) DMA reception.
+// 0: circular DMA, write position from NDTR (default).
+// 1: the two halves of dma_buf are DMA memory blocks M0/M1
+//    (HAL_DMAEx_MultiBufferStart_IT). UartRxRing_PollFromDma() delivers
+//    only completed blocks, each as one unit, so the consumer never sees a
+//    block the DMA is still writing. Latency is one block fill time: bytes
+//    of a partially filled block wait until it completes, so use it for
+//    continuous streams and size dma_buf accordingly. dma_size must be even.
+#ifndef UART_RX_RING_PINGPONG_DMA
+#define UART_RX_RING_PINGPONG_DMA 0
+#endif
+
+#if UART_RX_RING_PINGPONG_DMA && UART_RX_RING_IDLE_DMA
+#error "UART_RX_RING_PINGPONG_DMA and UART_RX_RING_IDLE_DMA are exclusive"
+#endif
+
+// Direct parse-from-DMA mode.
+// 0: bytes are copied from dma_buf into the SW ring (default).
+// 1: the SW ring is compiled out; Peek()/Commit()/Read() expose
+//    dma_buf[dma_read_pos..dma_last_pos) in place. Saves sw_buf RAM and one
+//    copy per byte. The consumer must drain what it peeked before DMA laps
+//    the buffer; UartRxRing_Stats keep their meaning (dropped_bytes counts
+//    unread bytes that DMA overwrote). Polling only (single context).
+#ifndef UART_RX_RING_DIRECT_DMA
+#define UART_RX_RING_DIRECT_DMA 0
+#endif
+
+#if UART_RX_RING_DIRECT_DMA && UART_RX_RING_IDLE_DMA
+#error "UART_RX_RING_DIRECT_DMA requires polling mode (UART_RX_RING_IDLE_DMA=0)"
+#endif
+
+// SW ring overflow policy (ignored in direct DMA mode).
+// DROP_BYTES:        drop the newest bytes that do not fit (default).
+// DROP_NEWEST_FRAME: keep the SW ring ending on a frame boundary (STX) and
+//                    drop the incoming frames that do not fit, whole.
+// DROP_OLDEST_FRAME: discard whole frames from the ring tail to make room.
+//                    The producer then moves sw_tail, so this needs IRQ
+//                    masking (UART_RX_RING_SPSC=0), polling mode, and no
+//                    PollFromDma() between Peek() and Commit().
+// Frame boundaries are MAVLink STX bytes; an STX value inside a payload
+// is taken as a boundary too, so dropped_frames is an estimate.
+#define UART_RX_RING_DROP_BYTES         0
+#define UART_RX_RING_DROP_NEWEST_FRAME  1
+#define UART_RX_RING_DROP_OLDEST_FRAME  2
+
+#ifndef UART_RX_RING_DROP_POLICY
+#define UART_RX_RING_DROP_POLICY UART_RX_RING_DROP_BYTES
+#endif
+
+#if (UART_RX_RING_DROP_POLICY == UART_RX_RING_DROP_OLDEST_FRAME) && (UART_RX_RING_SPSC || UART_RX_RING_IDLE_DMA)
+#error "UART_RX_RING_DROP_OLDEST_FRAME requires UART_RX_RING_SPSC=0 and UART_RX_RING_IDLE_DMA=0"
+#endif
+
+#ifndef UART_RX_RING_STX_V1
+#define UART_RX_RING_STX_V1 0xFEu // MAVLink 1 start byte
+#endif
+
+#ifndef UART_RX_RING_STX_V2
+#define UART_RX_RING_STX_V2 0xFDu // MAVLink 2 start byte
+#endif
+
+// Max number of rings that can receive HAL RX callbacks (lookup by huart).
+#ifndef UART_RX_RING_MAX_EVENT_RINGS
+#define UART_RX_RING_MAX_EVENT_RINGS 3u
+#endif
+
 typedef struct
 {
-    uint32_t pushed_bytes;     // total bytes moved into SW ring
-    uint32_t dropped_bytes;    // bytes dropped due to SW ring full
-    uint32_t overflow_events;  // number of times SW ring overflow happened
+    uint32_t pushed_bytes;     // total bytes moved into SW ring (direct mode: made readable)
+    uint32_t dropped_bytes;    // bytes dropped due to SW ring full (direct mode: unread, overwritten)
+    uint32_t overflow_events;  // number of polls that had to drop bytes (SW ring full)
+    uint32_t dropped_frames;   // frames dropped whole by a frame-aware drop policy
+    uint32_t lapped_bytes;     // bytes overwritten by DMA before they were polled
+    uint32_t lap_events;       // number of polls that detected a DMA lap-around
+    uint32_t max_poll_gap_ms;  // worst-case interval between PollFromDma() calls
+    uint32_t rx_restarts;      // DMA reception restarted after a UART/DMA error
 } UartRxRing_Stats;
 
+// Occupancy / batch-size instrumentation sampled on every DMA poll or RX
+// event. Costs ~150 bytes of RAM per ring; set to 0 to compile it out.
+#ifndef UART_RX_RING_HISTOGRAMS
+#define UART_RX_RING_HISTOGRAMS 1
+#endif
+
+// Log2 buckets: [0] = 0, [k] = 2^(k-1) .. 2^k - 1 (covers any uint16_t).
+#define UART_RX_RING_HIST_BUCKETS 17u
+
+typedef struct
+{
+    uint16_t high_water;                              // max SW ring occupancy seen (bytes)
+    uint32_t samples;                                 // number of polls/events sampled
+    uint32_t occupancy[UART_RX_RING_HIST_BUCKETS];    // SW ring bytes after each poll
+    uint32_t poll_bytes[UART_RX_RING_HIST_BUCKETS];   // new DMA bytes per poll
+} UartRxRing_Histograms;
+
+// Contiguous read-only view into SW ring memory (see UartRxRing_Peek()).
+typedef struct
+{
+    const uint8_t* data;
+    uint16_t len;
+} UartRxRing_Span;
+
 typedef struct
 {
     UART_HandleTypeDef* huart;
 
-    // DMA circular buffer (DMA writes here)
-    uint8_t  dma_buf[UART_RX_RING_DMA_BUF_SIZE];
+    // DMA circular buffer (DMA writes here), storage not owned
+    uint8_t* dma_buf;
     uint16_t dma_size;
     volatile uint16_t dma_last_pos;
 
-    // Software ring buffer (consumer reads from here)
-    uint8_t  sw_buf[UART_RX_RING_SW_BUF_SIZE];
+#if UART_RX_RING_DIRECT_DMA
+    // Consumer read position inside dma_buf
+    uint16_t dma_read_pos;
+#else
+    // Software ring buffer (consumer reads from here), storage not owned
+    uint8_t* sw_buf;
     uint16_t sw_size;
-    volatile uint16_t sw_head; // write index
-    volatile uint16_t sw_tail; // read index
+    volatile uint16_t sw_head; // write index (owned by producer)
+    volatile uint16_t sw_tail; // read index (owned by consumer)
+    uint8_t drop_until_stx;    // DROP_NEWEST_FRAME: skipping rest of a dropped frame
+#endif
 
     // Diagnostics
     volatile uint32_t pushed_bytes;
     volatile uint32_t dropped_bytes;
     volatile uint32_t overflow_events;
+    volatile uint32_t dropped_frames;
+
+    // DMA lap detection: HT/TC events counted by ISR vs boundaries consumed
+    // (ping-pong mode: completed blocks vs blocks delivered)
+    volatile uint32_t dma_half_events;
+    uint32_t dma_half_seen;
+    volatile uint32_t lapped_bytes;
+    volatile uint32_t lap_events;
+    uint32_t last_poll_ms;
+    volatile uint32_t max_poll_gap_ms;
+    volatile uint32_t rx_restarts;
+
+#if UART_RX_RING_HISTOGRAMS
+    UartRxRing_Histograms hist;
+#endif
 } UartRxRing;
 
+// Init with the module's default static buffers (UART_RX_RING_*_BUF_SIZE).
+// Only one ring may use the default storage; a second ring is left
+// unconfigured (UartRxRing_StartDma() returns HAL_ERROR).
 void UartRxRing_Init(UartRxRing* ring, UART_HandleTypeDef* huart);
 
+// Init with caller-provided storage, so each UART can be sized for its
+// baud rate. Buffers must outlive the ring; dma_buf must be DMA-reachable.
+// sw_size must be a power of two (sw_buf/sw_size are ignored in direct
+// DMA mode and may be NULL/0). Invalid arguments leave the ring
+// unconfigured (UartRxRing_StartDma() returns HAL_ERROR).
+void UartRxRing_InitWithBuffers(UartRxRing* ring, UART_HandleTypeDef* huart,
+                                uint8_t* dma_buf, uint16_t dma_size,
+                                uint8_t* sw_buf, uint16_t sw_size);
+
 // Starts DMA reception into internal circular DMA buffer.
 // Must be called once after init (and after UART is configured).
 HAL_StatusTypeDef UartRxRing_StartDma(UartRxRing* ring);
@@ -62,16 +216,57 @@ HAL_StatusTypeDef UartRxRing_StartDma(UartRxRing* ring);
 // Call from main loop (e.g., every 1-10 ms) OR from an IDLE callback.
 void UartRxRing_PollFromDma(UartRxRing* ring);
 
+// Called from HAL callbacks router (HAL_UART_RxHalfCpltCallback and
+// HAL_UART_RxCpltCallback). Counts DMA half/full boundaries for lap detection.
+void UartRxRing_OnDmaBoundary(UART_HandleTypeDef* huart);
+
+// DMA buffer size (bytes, power of two) that would have survived the
+// worst poll interval measured so far at the current baud rate, with 2x
+// margin. Returns 0 if nothing measured yet.
+uint32_t UartRxRing_GetRecommendedDmaSize(const UartRxRing* ring);
+
+#if UART_RX_RING_IDLE_DMA
+// Called from HAL callbacks router (HAL_UARTEx_RxEventCallback).
+// size is the DMA write position reported by HAL. Ignores unknown UARTs.
+void UartRxRing_OnRxEvent(UART_HandleTypeDef* huart, uint16_t size);
+
+#endif
+
+#if UART_RX_RING_IDLE_DMA || UART_RX_RING_PINGPONG_DMA
+// Called from HAL callbacks router (HAL_UART_ErrorCallback).
+// Restarts IDLE / ping-pong DMA reception after HAL aborted it (counted in
+// rx_restarts). Ignores unknown UARTs.
+void UartRxRing_OnError(UART_HandleTypeDef* huart);
+#endif
+
 // Reads up to max_len bytes from SW ring into out.
 // Returns number of bytes read.
 uint16_t UartRxRing_Read(UartRxRing* ring, uint8_t* out, uint16_t max_len);
 
+// Zero-copy read: exposes readable SW ring data in place as up to two
+// contiguous spans (second span is non-empty only when data wraps).
+// Data stays valid until UartRxRing_Commit() releases it.
+// Returns total number of bytes exposed (first->len + second->len).
+uint16_t UartRxRing_Peek(UartRxRing* ring, UartRxRing_Span* first, UartRxRing_Span* second);
+
+// Releases n bytes previously exposed by UartRxRing_Peek().
+// n is clamped to the number of bytes currently available.
+void UartRxRing_Commit(UartRxRing* ring, uint16_t n);
+
 // Returns how many bytes currently available in SW ring.
 uint16_t UartRxRing_Available(const UartRxRing* ring);
 
 // Read-only stats snapshot.
 void UartRxRing_GetStats(const UartRxRing* ring, UartRxRing_Stats* out_stats);
 
+#if UART_RX_RING_HISTOGRAMS
+// Snapshot of high-water mark and histograms (taken with IRQs masked).
+void UartRxRing_GetHistograms(const UartRxRing* ring, UartRxRing_Histograms* out_hist);
+
+// Clears high-water mark and histograms (e.g. after each log window).
+void UartRxRing_ResetHistograms(UartRxRing* ring);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Routes the MAVLink library's per-channel RX state to the MavlinkRx that
+// owns the channel, through the MAVLINK_GET_CHANNEL_STATUS/BUFFER hooks.
+// Must be included before any MAVLink header (mavlink_lib.h does this).
+//
+// Each MavlinkRx claims a free channel (MAVLINK_COMM_0..NUM_BUFFERS-1) on
+// init, so library calls made with that channel (mavlink_parse_char(),
+// mavlink_get_channel_status()->signing, ...) use the instance's own
+// parse status and frame slot. Channels nobody owns get a private status
+// and a shared scratch buffer.
+#if defined(MAVLINK_STX_MAVLINK1) && !defined(MAVLINK_GET_CHANNEL_STATUS)
+#error "mavlink_channel.h must be included before the MAVLink headers"
+#endif
+
+#define MAVLINK_GET_CHANNEL_STATUS
+#define MAVLINK_GET_CHANNEL_BUFFER
+
+struct __mavlink_status;
+struct __mavlink_message;
+
+struct __mavlink_status* mavlink_get_channel_status(uint8_t chan);
+struct __mavlink_message* mavlink_get_channel_buffer(uint8_t chan);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// X.25 (CRC16-MCRF4XX) used by MAVLink framing.
+//
+// Plugs a table-driven crc_accumulate() into the MAVLink C library through
+// its HAVE_CRC_ACCUMULATE hook, so this header must be included before any
+// MAVLink header (mavlink_lib.h does this).
+//
+// Pick the variant by flash budget:
+//   BITWISE - library shift/xor code, no tables
+//   TABLE   - 256-entry table, 512 B flash
+//   SLICE4  - TABLE + slicing-by-4 for buffers, 2 KB flash
+#define MAVLINK_CRC_IMPL_BITWISE 0
+#define MAVLINK_CRC_IMPL_TABLE   1
+#define MAVLINK_CRC_IMPL_SLICE4  2
+
+#ifndef MAVLINK_CRC_IMPL
+#define MAVLINK_CRC_IMPL MAVLINK_CRC_IMPL_SLICE4
+#endif
+
+#if (MAVLINK_CRC_IMPL != MAVLINK_CRC_IMPL_BITWISE)
+#if defined(X25_INIT_CRC) && !defined(HAVE_CRC_ACCUMULATE)
+#error "mavlink_crc.h must be included before the MAVLink headers"
+#endif
+
+#define HAVE_CRC_ACCUMULATE
+
+extern const uint16_t MavlinkCrc_Table[256];
+
+static inline void crc_accumulate(uint8_t data, uint16_t* crcAccum)
+{
+    *crcAccum = (uint16_t)((*crcAccum >> 8) ^ MavlinkCrc_Table[(uint8_t)(*crcAccum ^ data)]);
+}
+#endif
+
+#include "mavlink/checksum.h"
+
+// Bulk CRC update; use instead of crc_accumulate_buffer() on hot paths.
+void MavlinkCrc_AccumulateBuffer(uint16_t* crc, const uint8_t* data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+
+// The MAVLink C library as this project builds it. Include this instead of
+// mavlink/common/mavlink.h.
+//
+// The library is customised through hooks that must be defined before its
+// headers are parsed. They are all installed here, in one place, so a new
+// hook header is added to this list only.
+#if defined(MAVLINK_STX_MAVLINK1) && !defined(MAVLINK_GET_CHANNEL_STATUS)
+#error "MAVLink headers included before mavlink_lib.h: include only mavlink_lib.h"
+#endif
+
+#include "mavlink_crc.h"       // HAVE_CRC_ACCUMULATE
+#include "mavlink_msg_entry.h" // MAVLINK_GET_MSG_ENTRY
+#include "mavlink_channel.h"   // MAVLINK_GET_CHANNEL_STATUS/BUFFER
+#include "mavlink_sha.h"       // HAVE_MAVLINK_SHA256
+#include "mavlink/common/mavlink.h"
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// O(1) replacement for the library's bisecting mavlink_get_msg_entry(),
+// installed through the MAVLINK_GET_MSG_ENTRY hook. Must be included
+// before any MAVLink header (mavlink_lib.h does this).
+//
+// msgid < 512 is a direct index; the sparse high range uses a perfect hash.
+// Both tables are generated by scripts/gen_mavlink_msg_index.py. With
+// --keep (opt-in) the table holds only the listed messages (all hashed);
+// other ids then look up as NULL, see MAVLINK_RX_ACCEPT_UNKNOWN.
+#if defined(MAVLINK_STX_MAVLINK1) && !defined(MAVLINK_GET_MSG_ENTRY)
+#error "mavlink_msg_entry.h must be included before the MAVLink headers"
+#endif
+
+#define MAVLINK_GET_MSG_ENTRY
+
+struct __mavlink_msg_entry;
+const struct __mavlink_msg_entry* mavlink_get_msg_entry(uint32_t msgid);
+
+// Entries in the table, and 1 if it was trimmed to a subset of the dialect
+uint32_t MavlinkMsgEntry_Count(void);
+uint8_t MavlinkMsgEntry_IsTrimmed(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,15 +1,88 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "stm32f4xx_hal.h"
 #include "uart_rx_ring.h"
-#include "mavlink/common/mavlink.h"
+#include "mavlink_lib.h"
+#include "mavlink_sign.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 
+// MavlinkRx_GetChannel() result when all MAVLink channels are taken.
+#define MAVLINK_RX_NO_CHANNEL 0xFFu
+
+#ifndef MAVLINK_RX_SLOT_COUNT
+// Frame slots per MavlinkRx (~290 B each). The parser always owns one;
+// the rest can be held by consumers (see MavlinkRx_RetainMessage()).
+#define MAVLINK_RX_SLOT_COUNT 4u
+#endif
+
+#if (MAVLINK_RX_SLOT_COUNT < 1u) || (MAVLINK_RX_SLOT_COUNT > 32u)
+#error "MAVLINK_RX_SLOT_COUNT must be 1..32"
+#endif
+
+#ifndef MAVLINK_RX_INTEREST_IDS
+// Size of the per-msgid interest bitmap (bits). Higher msgids are always
+// treated as interesting.
+#define MAVLINK_RX_INTEREST_IDS 512u
+#endif
+
+#if ((MAVLINK_RX_INTEREST_IDS % 32u) != 0u)
+#error "MAVLINK_RX_INTEREST_IDS must be a multiple of 32"
+#endif
+
+#ifndef MAVLINK_RX_SKIP_CRC
+// 0: uninteresting frames skip the payload copy but are still CRC-checked
+//    before they are reported to on_skipped.
+// 1: their payload is not touched at all; on_skipped sees unverified frames.
+#define MAVLINK_RX_SKIP_CRC 0
+#endif
+
+#ifndef MAVLINK_RX_ACCEPT_UNKNOWN
+// 0: frames whose msgid has no CRC_EXTRA entry are rejected, like the
+//    reference parser does.
+// 1: they are accepted on framing plus the 8 CRC bits that do not depend
+//    on CRC_EXTRA, and go to on_skipped. Subscribers never see them.
+//    About 1 in 256 random frames passes, so line noise yields a fake
+//    frame every few seconds at 115200 baud. Only meant for a trimmed msg
+//    table (mavlink_msg_entry.h).
+#define MAVLINK_RX_ACCEPT_UNKNOWN 0
+#endif
+
+#ifndef MAVLINK_RX_RESYNC
+// 1: build in lookback resync (MavlinkRx_SetResync()). Costs one
+//    MAVLINK_MAX_PACKET_LEN buffer per MavlinkRx.
+#define MAVLINK_RX_RESYNC 1
+#endif
+
+#ifndef MAVLINK_RX_SUB_MAX
+// Subscriber entries per MavlinkRx (see MavlinkRx_Subscribe()).
+#define MAVLINK_RX_SUB_MAX 16u
+#endif
+
+#ifndef MAVLINK_RX_SUB_DIRECT_IDS
+// Msgids below this get a direct-indexed subscriber head (1 B each);
+// subscriptions to higher ids go to the sorted spill table.
+#define MAVLINK_RX_SUB_DIRECT_IDS 256u
+#endif
+
+#ifndef MAVLINK_RX_SUB_SPILL
+// Distinct high msgids that can have subscribers.
+#define MAVLINK_RX_SUB_SPILL 8u
+#endif
+
+#if (MAVLINK_RX_SUB_MAX < 1u) || (MAVLINK_RX_SUB_MAX > 255u)
+#error "MAVLINK_RX_SUB_MAX must be 1..255"
+#endif
+
+// MavlinkRx_Subscribe() msgid for a tap that sees every delivered message.
+#define MAVLINK_RX_SUB_ANY 0xFFFFFFFFu
+
 typedef void (*MavlinkRx_OnMessageFn)(void* ctx,
 #ifdef USE_MAVLINK_C_LIB
                                      const mavlink_message_t* msg
@@ -18,6 +91,47 @@ typedef void (*MavlinkRx_OnMessageFn)(void* ctx,
 #endif
 );
 
+#ifdef USE_MAVLINK_C_LIB
+// Parser counters (see MavlinkRx_GetStats()). Rough guide:
+//  - baud mismatch: bytes_discarded and bad_crc high, almost no frames
+//  - noisy radio:   steady frames, some bad_crc, frames_recovered > 0
+//  - dialect:       unknown_msgid (no CRC_EXTRA for the msgid, so the
+//                   frame was rejected without a check), or
+//                   frames_unvalidated with MAVLINK_RX_ACCEPT_UNKNOWN
+// With MAVLINK_RX_ACCEPT_UNKNOWN, an unknown-msgid frame that fails the
+// 8-bit CRC check counts as bad_crc, not unknown_msgid: it is corruption.
+typedef struct
+{
+    uint32_t frames_v1;                 // accepted MAVLink 1 frames
+    uint32_t frames_v2;                 // accepted MAVLink 2 frames
+    uint32_t frames_signed;             // of which signed
+    uint32_t frames_skipped;            // accepted but uninteresting (on_skipped)
+    uint32_t frames_recovered;          // found by lookback resync
+    uint32_t frames_unvalidated;        // unknown msgid, accepted unchecked (on_skipped)
+
+    uint32_t bad_crc;                   // CRC mismatch (or failed CRC-bits check, unknown msgid)
+    uint32_t unknown_msgid;             // no CRC_EXTRA entry and rejected unchecked
+    uint32_t bad_length;                // length too large for the buffer/msgid
+    uint32_t bad_incompat;              // unsupported incompat_flags
+    uint32_t bad_signature;             // signature/timestamp rejected, or unsigned on a signed link
+
+    uint32_t bytes_discarded;           // skipped while hunting for STX
+} MavlinkRx_Stats;
+
+typedef struct
+{
+    MavlinkRx_OnMessageFn fn;
+    void* ctx;
+    uint8_t next;                       // 1-based index into subs[], 0 = end
+} MavlinkRx_Sub;
+
+typedef struct
+{
+    uint32_t msgid;
+    uint8_t head;
+} MavlinkRx_SubSpill;
+#endif
+
 typedef struct
 {
     UART_HandleTypeDef* huart;
@@ -28,11 +142,51 @@ typedef struct
     void* on_message_ctx;
 
 #ifdef USE_MAVLINK_C_LIB
+    // Span parser state. Frames are assembled in place in a pool slot
+    // (rx_msg) and that slot is handed to on_message; nothing is copied.
     mavlink_status_t mav_status;
+    mavlink_message_t slots[MAVLINK_RX_SLOT_COUNT];
+    uint32_t slot_busy;                 // bit i: slot i assembling or retained
+    mavlink_message_t* rx_msg;
+    uint8_t chan;                       // MAVLink channel owned, see mavlink_channel.h
+    MavlinkRx_Stats stats;
+    MavlinkSign_Link* sign_link;        // signed-link mode when set
+
+    // Per-msgid interest. Frames whose bit is clear are not copied into the
+    // slot and go to on_skipped (header fields only) instead of on_message.
+    uint32_t interest[MAVLINK_RX_INTEREST_IDS / 32u];
+    uint8_t rx_skip;                    // current frame is uninteresting
+    uint8_t rx_unknown;                 // current msgid has no CRC_EXTRA entry
+    MavlinkRx_OnMessageFn on_skipped;
+    void* on_skipped_ctx;
+
+#if MAVLINK_RX_RESYNC
+    // Raw bytes of the frame being assembled, rescanned from the byte after
+    // its STX when the frame is rejected (see MavlinkRx_SetResync()).
+    uint8_t resync_enabled;
+    uint8_t rx_rejected;                // rejection waiting for a rescan
+    uint16_t resync_len;
+    uint8_t resync_buf[MAVLINK_MAX_PACKET_LEN];
+#endif
+
+    // Subscribers. Each msgid has a chain of subs[] entries, found through
+    // sub_direct[] for low ids or a binary search of sub_spill[] otherwise.
+    MavlinkRx_Sub subs[MAVLINK_RX_SUB_MAX];
+    uint8_t sub_count;
+    uint8_t sub_tap;                    // chain for MAVLINK_RX_SUB_ANY
+    uint8_t sub_direct[MAVLINK_RX_SUB_DIRECT_IDS];
+    MavlinkRx_SubSpill sub_spill[MAVLINK_RX_SUB_SPILL];  // sorted by msgid
+    uint8_t sub_spill_count;
 #endif
 } MavlinkRx;
 
 void MavlinkRx_Init(MavlinkRx* self, UART_HandleTypeDef* huart);
+
+// Same as MavlinkRx_Init(), but RX ring storage is supplied by the caller
+// (see UartRxRing_InitWithBuffers()). Use this for every link beyond the first.
+void MavlinkRx_InitWithBuffers(MavlinkRx* self, UART_HandleTypeDef* huart,
+                               uint8_t* dma_buf, uint16_t dma_size,
+                               uint8_t* sw_buf, uint16_t sw_size);
 HAL_StatusTypeDef MavlinkRx_Start(MavlinkRx* self);
 
 // Call frequently from main loop.
@@ -40,10 +194,88 @@ HAL_StatusTypeDef MavlinkRx_Start(MavlinkRx* self);
 // If MAVLink parsing enabled, it will emit messages via callback.
 void MavlinkRx_Update(MavlinkRx* self);
 
+#ifdef USE_MAVLINK_C_LIB
+// Feed a contiguous block of received bytes to the frame parser.
+// Frames may span several calls. Produces exactly the same messages and
+// accept/reject decisions as feeding the bytes to mavlink_parse_char()
+// one by one, but scans for STX and copies/CRCs the payload in bulk.
+// Returns the number of messages delivered (subscribers / on_message).
+uint32_t MavlinkRx_ParseSpan(MavlinkRx* self, const uint8_t* data, size_t len);
+
+// Interest filter (everything is interesting after init). Skipping only
+// applies while no signing is configured, since a signature cannot be
+// checked without the payload.
+void MavlinkRx_SetInterest(MavlinkRx* self, uint32_t msgid, bool interested);
+void MavlinkRx_SetInterestAll(MavlinkRx* self, bool interested);
+
+// Called for every valid uninteresting frame. Only the header fields
+// (len, seq, sysid, compid, msgid, flags) are meaningful; the payload is not.
+void MavlinkRx_SetOnSkipped(MavlinkRx* self, MavlinkRx_OnMessageFn fn, void* ctx);
+
+#if MAVLINK_RX_RESYNC
+// Lookback resync (off after init). The stock parser drops every byte of a
+// rejected frame and hunts for the next STX after it, so a frame whose STX
+// was swallowed by a corrupted or truncated one is lost. With resync on,
+// the rejected frame's bytes are rescanned from the byte after its STX and
+// such frames are recovered. Candidates that fail during the rescan count
+// as parse errors like any other rejected frame.
+void MavlinkRx_SetResync(MavlinkRx* self, bool enabled);
+#endif
+
+// Call fn for every message with this msgid, or for every delivered message
+// when msgid is MAVLINK_RX_SUB_ANY. A msgid may have several subscribers;
+// they run in registration order, after the taps and before on_message.
+// Subscribing also marks the msgid as interesting. Intended for init time:
+// there is no unsubscribe. Returns false when the tables are full, or when
+// the msgid is missing from the (possibly trimmed) CRC_EXTRA table.
+bool MavlinkRx_Subscribe(MavlinkRx* self, uint32_t msgid, MavlinkRx_OnMessageFn fn, void* ctx);
+
+// The message passed to on_message or a subscriber is only valid during
+// the callback. MAVLink 2 payloads truncated by the sender arrive zero-filled
+// to the message's full length, so field getters need no length checks.
+// To keep it (e.g. queue it for a later stage) without copying, call
+// MavlinkRx_RetainMessage() from the callback; it returns false if no
+// spare slot is left or another handler already retained the frame, in
+// which case copy the message instead.
+// Retained messages must be returned with MavlinkRx_ReleaseMessage().
+bool MavlinkRx_RetainMessage(MavlinkRx* self, const mavlink_message_t* msg);
+void MavlinkRx_ReleaseMessage(MavlinkRx* self, const mavlink_message_t* msg);
+
+// Snapshot of the parser counters; reset != 0 clears them afterwards.
+void MavlinkRx_GetStats(MavlinkRx* self, MavlinkRx_Stats* out_stats, uint8_t reset);
+
+// Signed-link mode: frames are only delivered with a valid signature and
+// timestamp (see mavlink_sign.h); unsigned frames are rejected unless
+// link->signing.accept_unsigned_callback lets them through. NULL turns
+// signing off. While on, interest skipping is suspended because the
+// signature covers the payload.
+void MavlinkRx_SetSigning(MavlinkRx* self, MavlinkSign_Link* link);
+
+// MAVLink channel claimed at init (MAVLINK_COMM_0..MAVLINK_COMM_NUM_BUFFERS-1),
+// or MAVLINK_RX_NO_CHANNEL if every channel already had an owner. The
+// channel's library status and buffer are this instance's own, so it is the
+// one to pass to mavlink_get_channel_status() (e.g. to configure signing).
+uint8_t MavlinkRx_GetChannel(const MavlinkRx* self);
+
+// Gives the channel back (only MAVLINK_COMM_NUM_BUFFERS exist), e.g. when a
+// temporary parser is done. The instance must not parse afterwards until it
+// is initialized again, which claims a channel anew.
+void MavlinkRx_ReleaseChannel(MavlinkRx* self);
+
+// From inside on_skipped / a subscriber: true if the frame being delivered
+// passed a full CRC check. False for MAVLINK_RX_ACCEPT_UNKNOWN frames and
+// for skipped frames with MAVLINK_RX_SKIP_CRC; their header may be noise.
+bool MavlinkRx_IsValidated(const MavlinkRx* self);
+#endif
+
 void MavlinkRx_SetOnMessage(MavlinkRx* self, MavlinkRx_OnMessageFn fn, void* ctx);
 
 // Optional: diagnostics passthrough
 void MavlinkRx_GetRxStats(MavlinkRx* self, UartRxRing_Stats* out_stats);
+uint32_t MavlinkRx_GetRecommendedDmaSize(const MavlinkRx* self);
+#if UART_RX_RING_HISTOGRAMS
+void MavlinkRx_GetRxHistograms(MavlinkRx* self, UartRxRing_Histograms* out_hist, uint8_t reset);
+#endif
 
 #ifdef __cplusplus
 }
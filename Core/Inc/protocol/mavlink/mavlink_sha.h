@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// SHA-256 used by MAVLink 2 signing.
+//
+// Replaces the library's mavlink_sha256_* (byte-wise buffering, a 64-word
+// schedule array and rolled rounds) through its HAVE_MAVLINK_SHA256 hook
+// with a speed-optimized version: unrolled rounds, a rolling 16-word
+// schedule and whole blocks hashed straight from the caller's buffer.
+// Same API, so mavlink_sign_packet() and mavlink_signature_check() use it.
+// Must be included before any MAVLink header (mavlink_lib.h does this).
+#if defined(MAVLINK_STX_MAVLINK1) && !defined(HAVE_MAVLINK_SHA256)
+#error "mavlink_sha.h must be included before the MAVLink headers"
+#endif
+
+#define HAVE_MAVLINK_SHA256
+
+typedef struct
+{
+    uint32_t state[8];
+    uint32_t count;                     // bytes hashed so far
+    union
+    {
+        uint8_t bytes[64];
+        uint32_t words[16];
+    } block;                            // pending partial block
+} mavlink_sha256_ctx;
+
+void mavlink_sha256_init(mavlink_sha256_ctx* m);
+void mavlink_sha256_update(mavlink_sha256_ctx* m, const void* v, uint32_t len);
+
+// First 48 bits of the digest, as used in MAVLink signatures.
+void mavlink_sha256_final_48(mavlink_sha256_ctx* m, uint8_t result[6]);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "mavlink_lib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// MAVLink 2 signed-link support for MavlinkRx (see MavlinkRx_SetSigning()).
+//
+// A MavlinkSign_Link holds the library signing state of one link (key in
+// use, link clock, per-stream timestamps). Keys come from a
+// MavlinkSign_KeyStore shared by all links; if the key in use does not
+// match, the other stored keys are tried so a key can be rotated without
+// dropping the link.
+//
+// Timestamps (10 us units since 2015-01-01) must increase per
+// (sysid, compid, link_id) stream. The link clock is the newest accepted
+// timestamp advanced by local time; frames more than MAVLINK_SIGN_WINDOW_MS
+// ahead of it, and new streams more than MAVLINK_SIGNING_TIMESTAMP_LIMIT
+// seconds behind it, are rejected. Until the first accepted frame (or
+// MavlinkSign_SetTimestamp()) there is no clock and any timestamp passes.
+
+#ifndef MAVLINK_SIGN_KEY_SLOTS
+#define MAVLINK_SIGN_KEY_SLOTS 2u
+#endif
+
+#ifndef MAVLINK_SIGN_WINDOW_MS
+#define MAVLINK_SIGN_WINDOW_MS 10000u
+#endif
+
+#define MAVLINK_SIGN_KEY_LEN 32u
+
+typedef enum
+{
+    MAVLINK_SIGN_OK = 0,
+    MAVLINK_SIGN_NO_KEY,
+    MAVLINK_SIGN_BAD_SIGNATURE,
+    MAVLINK_SIGN_TOO_MANY_STREAMS,
+    MAVLINK_SIGN_OLD_TIMESTAMP,         // new stream too far behind the link clock
+    MAVLINK_SIGN_REPLAY,                // not newer than the stream's last frame
+    MAVLINK_SIGN_FUTURE_TIMESTAMP,      // too far ahead of the link clock
+    MAVLINK_SIGN_RESULT_COUNT
+} MavlinkSign_Result;
+
+typedef struct
+{
+    uint8_t key[MAVLINK_SIGN_KEY_SLOTS][MAVLINK_SIGN_KEY_LEN];
+    uint8_t valid;                      // bit i: key[i] loaded
+} MavlinkSign_KeyStore;
+
+typedef struct
+{
+    mavlink_signing_t signing;          // secret_key = key in use, timestamp = link clock
+    mavlink_signing_streams_t streams;
+    const MavlinkSign_KeyStore* keys;
+    uint8_t key_slot;
+    bool synced;                        // link clock valid
+    uint32_t clock_ms;                  // local time of the last clock update
+
+    uint32_t results[MAVLINK_SIGN_RESULT_COUNT];
+} MavlinkSign_Link;
+
+void MavlinkSign_KeyStoreInit(MavlinkSign_KeyStore* self);
+bool MavlinkSign_KeyStoreSet(MavlinkSign_KeyStore* self, uint8_t slot, const uint8_t key[MAVLINK_SIGN_KEY_LEN]);
+
+// Wipes the key.
+void MavlinkSign_KeyStoreClear(MavlinkSign_KeyStore* self, uint8_t slot);
+
+// Starts with key_slot; keys must outlive the link. link_id goes into outgoing signatures only; incoming
+// streams are told apart by the link_id in their own signatures.
+void MavlinkSign_LinkInit(MavlinkSign_Link* self, const MavlinkSign_KeyStore* keys,
+                          uint8_t key_slot, uint8_t link_id);
+
+// Seed the link clock from a trusted time source (e.g. GPS).
+void MavlinkSign_SetTimestamp(MavlinkSign_Link* self, uint64_t timestamp, uint32_t now_ms);
+
+// Verify the signature block of a received signed frame and update the
+// stream timestamps. Also counted in results[].
+MavlinkSign_Result MavlinkSign_Check(MavlinkSign_Link* self, const mavlink_message_t* msg, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,7 +6,7 @@
 #include "mavlink_rx.h"
 #include "stm32f4xx_hal.h"
 #include "app_tests.h"
-#include "mavlink/common/mavlink.h"
+#include "mavlink_lib.h"
 #include "app/telemetry/telemetry.h"
 #include "health_rules.h"
 
@@ -17,7 +17,8 @@ static MavlinkRx s_mav_rx;
 
 static LedMode s_mode = LED_MODE_BLINK;
 
-static void OnMavlinkMessage(void* ctx, const mavlink_message_t* msg);
+static void OnMavlinkCount(void* ctx, const mavlink_message_t* msg);
+static void OnTelemetryMessage(void* ctx, const mavlink_message_t* msg);
 
 static LedMode App_NextMode(LedMode mode)
 {
@@ -48,7 +49,23 @@ void App_Init(void)
     Logger_Init();
 
     MavlinkRx_Init(&s_mav_rx, &huart1);
-    MavlinkRx_SetOnMessage(&s_mav_rx, OnMavlinkMessage, NULL);
+#if MAVLINK_RX_RESYNC
+    // Telemetry radios drop bytes; recover frames hidden in broken ones.
+    MavlinkRx_SetResync(&s_mav_rx, true);
+#endif
+
+    // Only messages Telemetry decodes need their payload (subscribing marks
+    // them interesting); every message, skipped or not, is counted.
+    const TelemetryMsgHandler* handlers = NULL;
+    uint32_t handler_count = Telemetry_GetMsgHandlers(&handlers);
+    MavlinkRx_SetInterestAll(&s_mav_rx, false);
+    (void)MavlinkRx_Subscribe(&s_mav_rx, MAVLINK_RX_SUB_ANY, OnMavlinkCount, &s_mav_rx);
+    for (uint32_t i = 0u; i < handler_count; i++)
+    {
+        (void)MavlinkRx_Subscribe(&s_mav_rx, handlers[i].msgid, OnTelemetryMessage, (void*)&handlers[i]);
+    }
+    MavlinkRx_SetOnSkipped(&s_mav_rx, OnMavlinkCount, &s_mav_rx);
+
     HAL_StatusTypeDef status = MavlinkRx_Start(&s_mav_rx);
     Logger_Write(LOG_LEVEL_INFO, "App_Init", "MavlinkRx_Start status=%d", (int)status);
 
@@ -64,6 +81,14 @@ void App_Update(uint32_t now_ms)
 	HealthRules_Update(now_ms);
 
 	//AppTest_MavlinkRx_LogRxStatsOncePerSecond(&s_mav_rx);
+	//AppTest_MavlinkRx_LogParserStatsOncePerSecond(&s_mav_rx);
+	//AppTest_MavlinkRx_LogRxHistogramsOncePerSecond(&s_mav_rx);
+	//AppTest_MavlinkCrc_BenchmarkOnce();
+	//AppTest_MavlinkMsgEntry_VerifyOnce();
+	//AppTest_MavlinkRx_ResyncNoiseOnce();
+	//AppTest_MavlinkSign_BenchmarkOnce();
+	//AppTest_MavlinkRx_DiffParseCharOnce();
+	//AppTest_UartRxRing_SpscStressOnce();
 
     Led_Update(now_ms);
 
@@ -87,8 +112,14 @@ void App_Update(uint32_t now_ms)
     }
 }
 
-static void OnMavlinkMessage(void* ctx, const mavlink_message_t* msg)
+static void OnMavlinkCount(void* ctx, const mavlink_message_t* msg)
+{
+    const MavlinkRx* rx = (const MavlinkRx*)ctx;
+    Telemetry_OnMavlinkHeader(msg, HAL_GetTick(), MavlinkRx_IsValidated(rx));
+}
+
+static void OnTelemetryMessage(void* ctx, const mavlink_message_t* msg)
 {
-    (void)ctx;
-    Telemetry_OnMavlink(msg, HAL_GetTick());
+    const TelemetryMsgHandler* handler = (const TelemetryMsgHandler*)ctx;
+    handler->fn(msg, HAL_GetTick());
 }
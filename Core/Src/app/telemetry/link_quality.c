@@ -0,0 +1,106 @@
+#include "app/telemetry/link_quality.h"
+#include <stddef.h>
+#include <string.h>
+
+static void LinkQuality_AddWindow(LinkQuality* self, uint16_t received, uint16_t lost)
+{
+    self->win_received = (uint16_t)(self->win_received + received);
+    self->win_lost = (uint16_t)(self->win_lost + lost);
+
+    if (((uint32_t)self->win_received + self->win_lost) >= LINK_QUALITY_WINDOW)
+    {
+        self->win_received = (uint16_t)(self->win_received / 2u);
+        self->win_lost = (uint16_t)(self->win_lost / 2u);
+    }
+}
+
+void LinkQuality_Init(LinkQuality* self)
+{
+    if (self == NULL)
+    {
+        return;
+    }
+
+    (void)memset(self, 0, sizeof(*self));
+}
+
+void LinkQuality_OnFrame(LinkQuality* self, uint8_t seq)
+{
+    if (self == NULL)
+    {
+        return;
+    }
+
+    if (self->history == 0u)
+    {
+        // First frame from this source
+        self->next_seq = (uint8_t)(seq + 1u);
+        self->history = 1u;
+        self->received++;
+        LinkQuality_AddWindow(self, 1u, 0u);
+        return;
+    }
+
+    uint8_t ahead = (uint8_t)(seq - self->next_seq);
+    if (ahead < 128u)
+    {
+        // In order, or after `ahead` missing frames
+        self->history = (ahead >= 31u) ? 1u : ((self->history << (ahead + 1u)) | 1u);
+        self->next_seq = (uint8_t)(seq + 1u);
+        self->received++;
+        self->lost += ahead;
+        LinkQuality_AddWindow(self, 1u, ahead);
+        return;
+    }
+
+    uint8_t back = (uint8_t)(self->next_seq - 1u - seq);
+    if (back >= 32u)
+    {
+        // Far behind: most likely the sender restarted its sequence
+        self->next_seq = (uint8_t)(seq + 1u);
+        self->history = 1u;
+        self->received++;
+        LinkQuality_AddWindow(self, 1u, 0u);
+    }
+    else if ((self->history & (1uL << back)) != 0u)
+    {
+        self->duplicated++;
+    }
+    else
+    {
+        // Late frame that was counted as lost when the gap was seen
+        self->history |= (1uL << back);
+        self->reordered++;
+        self->received++;
+        if (self->lost > 0u)
+        {
+            self->lost--;
+        }
+        if (self->win_lost > 0u)
+        {
+            self->win_lost--;
+        }
+        LinkQuality_AddWindow(self, 1u, 0u);
+    }
+}
+
+uint16_t LinkQuality_LossPermille(const LinkQuality* self)
+{
+    uint32_t frames = LinkQuality_WindowFrames(self);
+    if (frames == 0u)
+    {
+        return 0u;
+    }
+
+    return (uint16_t)(((uint32_t)self->win_lost * 1000u) / frames);
+}
+
+uint32_t LinkQuality_WindowFrames(const LinkQuality* self)
+{
+    if (self == NULL)
+    {
+        return 0u;
+    }
+
+    return (uint32_t)self->win_received + self->win_lost;
+}
@@ -1,11 +1,20 @@
 #include "app/telemetry/mavlink_summary.h"
 #include "app/telemetry/telemetry.h"
 #include "logger.h"
+#include <stdio.h>
 #include <string.h>
 
+// Sources listed in the loss= field (keeps the line within the log buffer)
+#ifndef MAV_SUM_LOSS_SOURCES
+#define MAV_SUM_LOSS_SOURCES 3u
+#endif
+
+#define MAV_SUM_MSGID_MASK  (MAV_SUM_MSGID_SLOTS - 1u)
+#define MAV_SUM_MSGID_LIMIT (MAV_SUM_MSGID_SLOTS - (MAV_SUM_MSGID_SLOTS / 8u))
+
 typedef struct TopMsg
 {
-    uint8_t id;
+    uint32_t id;
     uint16_t count;
 } TopMsg;
 
@@ -86,6 +95,41 @@ static void MavSummary_FillLogFields(MavSumLogFields* out, uint32_t now_ms, cons
 }
 
 
+// "sys/comp:loss% ..." for the first sources, "+N" if more, "-" if none.
+static void MavSummary_FormatLoss(char* out, size_t size)
+{
+    size_t off = 0u;
+    uint32_t count = Telemetry_GetSourceCount();
+
+    out[0] = '\0';
+    if (count == 0u)
+    {
+        (void)snprintf(out, size, "-");
+        return;
+    }
+
+    for (uint32_t i = 0u; (i < count) && (i < MAV_SUM_LOSS_SOURCES); i++)
+    {
+        const TelemetryState* src = Telemetry_GetSource(i);
+        uint16_t loss = LinkQuality_LossPermille(&src->link);
+        int n = snprintf(&out[off], size - off, "%s%u/%u:%u.%u%%",
+                         (i == 0u) ? "" : " ",
+                         (unsigned)src->sysid, (unsigned)src->compid,
+                         (unsigned)(loss / 10u), (unsigned)(loss % 10u));
+        if ((n < 0) || ((size_t)n >= (size - off)))
+        {
+            return;
+        }
+        off += (size_t)n;
+    }
+
+    if (count > MAV_SUM_LOSS_SOURCES)
+    {
+        (void)snprintf(&out[off], size - off, " +%u", (unsigned)(count - MAV_SUM_LOSS_SOURCES));
+    }
+}
+
+
 static void MavSummary_FindTop3(const MavlinkSummary* self, TopMsg out_top[3])
 {
     if (out_top == NULL)
@@ -108,7 +152,7 @@ static void MavSummary_FindTop3(const MavlinkSummary* self, TopMsg out_top[3])
         return;
     }
 
-    for (uint16_t i = 0u; i < MAV_SUM_MSGID_MAX; i++)
+    for (uint32_t i = 0u; i < MAV_SUM_MSGID_SLOTS; i++)
     {
         uint16_t c = self->win_msgid_counts[i];
         if (c == 0u)
@@ -117,7 +161,7 @@ static void MavSummary_FindTop3(const MavlinkSummary* self, TopMsg out_top[3])
         }
 
         // For equal counts, prefer smaller msgid to keep output stable.
-        uint8_t id = (uint8_t)i;
+        uint32_t id = self->win_msgid_ids[i];
 
         if ((c > out_top[0].count) || ((c == out_top[0].count) && (id < out_top[0].id)))
         {
@@ -138,6 +182,36 @@ static void MavSummary_FindTop3(const MavlinkSummary* self, TopMsg out_top[3])
 }
 
 
+// Count one message of this msgid in the window hash.
+static void MavSummary_CountMsgId(MavlinkSummary* self, uint32_t msgid)
+{
+    uint32_t i = ((msgid * 2654435761u) >> 16) & MAV_SUM_MSGID_MASK;
+
+    while (self->win_msgid_counts[i] != 0u)
+    {
+        if (self->win_msgid_ids[i] == msgid)
+        {
+            if (self->win_msgid_counts[i] != UINT16_MAX)
+            {
+                self->win_msgid_counts[i]++;
+            }
+            return;
+        }
+        i = (i + 1u) & MAV_SUM_MSGID_MASK;
+    }
+
+    if (self->win_msgid_used >= MAV_SUM_MSGID_LIMIT)
+    {
+        self->win_msgid_dropped++;
+        return;
+    }
+
+    self->win_msgid_ids[i] = msgid;
+    self->win_msgid_counts[i] = 1u;
+    self->win_msgid_used++;
+}
+
+
 void MavlinkSummary_Init(MavlinkSummary* self, uint32_t period_ms)
 {
     if (self == NULL)
@@ -161,17 +235,12 @@ void MavlinkSummary_OnMessage(MavlinkSummary* self, const mavlink_message_t* msg
     self->total_msgs++;
     self->win_msgs++;
 
-    uint8_t id = (uint8_t)msg->msgid;
-
-    self->last_msgid = id;
+    self->last_msgid = msg->msgid;
     self->last_sysid = msg->sysid;
     self->last_compid = msg->compid;
 
     // Count per-msgid frequency in the current window.
-    if (id < MAV_SUM_MSGID_MAX)
-    {
-        self->win_msgid_counts[id]++;
-    }
+    MavSummary_CountMsgId(self, msg->msgid);
 
     // Heartbeat counters must match msgid==0
     if (msg->msgid == MAVLINK_MSG_ID_HEARTBEAT)
@@ -219,7 +288,7 @@ void MavlinkSummary_UpdateAndLog(MavlinkSummary* self, uint32_t now_ms, const st
     }
     self->last_log_ms = now_ms;
 
-    // Collect fields from telemetry state (read-only)
+    // Collect fields from the primary source's telemetry state (read-only)
     MavSumLogFields f;
     MavSummary_FillLogFields(&f, now_ms, tlm);
 
@@ -227,11 +296,15 @@ void MavlinkSummary_UpdateAndLog(MavlinkSummary* self, uint32_t now_ms, const st
     TopMsg top[3];
     MavSummary_FindTop3(self, top);
 
+    // Windowed sequence loss per source
+    char loss[48];
+    MavSummary_FormatLoss(loss, sizeof(loss));
+
     // One unified log line (no branching)
     // NOTE: has_batt/has_gps indicate whether batt_v/gps_fix/sats are valid.
     Logger_Write(LOG_LEVEL_INFO, "MAV_SUM",
         "msgs=%lu hb=%lu link_dt=%lums hb_dt=%lums armed=%u has_batt=%u batt=%.2fV has_gps=%u gps_fix=%u sats=%u "
-        "last=%u sys=%u comp=%u top=%u(%u) %u(%u) %u(%u)",
+        "last=%u sys=%u comp=%u top=%u(%u) %u(%u) %u(%u) drop=%lu loss=%s",
         (unsigned long)self->win_msgs,
         (unsigned long)self->win_hb,
         (unsigned long)f.link_dt,
@@ -247,13 +320,17 @@ void MavlinkSummary_UpdateAndLog(MavlinkSummary* self, uint32_t now_ms, const st
         (unsigned)self->last_compid,
         (unsigned)top[0].id, (unsigned)top[0].count,
         (unsigned)top[1].id, (unsigned)top[1].count,
-        (unsigned)top[2].id, (unsigned)top[2].count);
+        (unsigned)top[2].id, (unsigned)top[2].count,
+        (unsigned long)self->win_msgid_dropped,
+        loss);
 
     // Reset window after logging
     self->win_msgs = 0u;
     self->win_hb = 0u;
 
     (void)memset(self->win_msgid_counts, 0, sizeof(self->win_msgid_counts));
+    self->win_msgid_used = 0u;
+    self->win_msgid_dropped = 0u;
     self->win_sys_status = 0u;
     self->win_gps_raw_int = 0u;
     self->win_attitude = 0u;
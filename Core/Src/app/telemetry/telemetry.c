@@ -3,90 +3,282 @@
 
 #include "app/telemetry/mavlink_summary.h"
 
-static TelemetryState s_tlm;
+// Sources live in s_src[0..s_src_count); s_index is a linear-probing hash
+// of (sysid, compid) holding s_src position + 1 (0 = empty slot).
+static TelemetryState s_src[TELEMETRY_MAX_SOURCES];
+static uint8_t s_index[TELEMETRY_INDEX_SIZE];
+static uint32_t s_src_count;
+static uint32_t s_evictions;
 static MavlinkSummary s_sum;
 
-void Telemetry_Init(void)
-{
-    (void)memset(&s_tlm, 0, sizeof(s_tlm));
+#define TELEMETRY_INDEX_MASK (TELEMETRY_INDEX_SIZE - 1u)
 
-    // Log one summary line per second.
-    MavlinkSummary_Init(&s_sum, 1000u);
+static uint32_t Telemetry_Home(uint8_t sysid, uint8_t compid)
+{
+    uint32_t key = ((uint32_t)sysid << 8) | compid;
+    return ((key * 2654435761u) >> 16) & TELEMETRY_INDEX_MASK;
 }
 
-void Telemetry_OnMavlink(const mavlink_message_t* msg, uint32_t now_ms)
+// Index slot holding the source, or the empty slot ending its probe run.
+static uint32_t Telemetry_Probe(uint8_t sysid, uint8_t compid)
 {
-    (void)now_ms;
+    uint32_t i = Telemetry_Home(sysid, compid);
 
-    if (msg == NULL)
+    while (s_index[i] != 0u)
     {
-        return;
+        const TelemetryState* t = &s_src[s_index[i] - 1u];
+        if ((t->sysid == sysid) && (t->compid == compid))
+        {
+            break;
+        }
+        i = (i + 1u) & TELEMETRY_INDEX_MASK;
     }
 
-    // Update summary aggregator (log output happens in Telemetry_Update).
-    MavlinkSummary_OnMessage(&s_sum, msg);
+    return i;
+}
 
-    // Remember the source of the last message (often useful for debugging)
-    s_tlm.sysid = msg->sysid;
-    s_tlm.compid = msg->compid;
-    s_tlm.last_msg_ms = now_ms;
-    s_tlm.msg_count++;
+// Empty the index slot and pull later entries of the probe run back into
+// the hole, so lookups never need tombstones.
+static void Telemetry_IndexRemove(uint32_t hole)
+{
+    uint32_t j = hole;
 
-    switch (msg->msgid)
+    s_index[hole] = 0u;
+    for (;;)
     {
-        case MAVLINK_MSG_ID_HEARTBEAT:
+        j = (j + 1u) & TELEMETRY_INDEX_MASK;
+        if (s_index[j] == 0u)
         {
-            mavlink_heartbeat_t hb;
-            mavlink_msg_heartbeat_decode(msg, &hb);
-
-            s_tlm.last_hb_ms = now_ms;
-            s_tlm.hb_count++;
-
-            // MAV_MODE_FLAG_SAFETY_ARMED indicates "armed" state
-            s_tlm.armed = ((hb.base_mode & MAV_MODE_FLAG_SAFETY_ARMED) != 0u);
-            break;
+            return;
         }
 
-        case MAVLINK_MSG_ID_SYS_STATUS:
+        const TelemetryState* t = &s_src[s_index[j] - 1u];
+        uint32_t home = Telemetry_Home(t->sysid, t->compid);
+        if (((j - home) & TELEMETRY_INDEX_MASK) >= ((j - hole) & TELEMETRY_INDEX_MASK))
         {
-            mavlink_sys_status_t st;
-            mavlink_msg_sys_status_decode(msg, &st);
+            s_index[hole] = s_index[j];
+            s_index[j] = 0u;
+            hole = j;
+        }
+    }
+}
 
-            // battery_voltage is in millivolts. UINT16_MAX means "unknown".
-            if (st.voltage_battery != UINT16_MAX)
+// Find the sender's state, adding it (or replacing the least recently heard
+// sender when full) on first contact.
+static TelemetryState* Telemetry_Source(uint8_t sysid, uint8_t compid)
+{
+    uint32_t slot = Telemetry_Probe(sysid, compid);
+    if (s_index[slot] != 0u)
+    {
+        return &s_src[s_index[slot] - 1u];
+    }
+
+    uint32_t pos;
+    if (s_src_count < TELEMETRY_MAX_SOURCES)
+    {
+        pos = s_src_count;
+        s_src_count++;
+    }
+    else
+    {
+        // LRU: the sender with the oldest last message. Only runs for a new
+        // sender on a full table.
+        pos = 0u;
+        for (uint32_t i = 1u; i < s_src_count; i++)
+        {
+            if ((int32_t)(s_src[i].last_msg_ms - s_src[pos].last_msg_ms) < 0)
             {
-                s_tlm.has_battery = true;
-                s_tlm.battery_voltage_v = ((float)st.voltage_battery) * 0.001f;
+                pos = i;
             }
-            break;
         }
 
-        case MAVLINK_MSG_ID_GPS_RAW_INT:
-        {
-            mavlink_gps_raw_int_t gps;
-            mavlink_msg_gps_raw_int_decode(msg, &gps);
+        Telemetry_IndexRemove(Telemetry_Probe(s_src[pos].sysid, s_src[pos].compid));
+        slot = Telemetry_Probe(sysid, compid);
+        s_evictions++;
+    }
 
-            s_tlm.has_gps = true;
-            s_tlm.gps_fix_type = gps.fix_type;
-            s_tlm.gps_sats_visible = gps.satellites_visible;
-            break;
+    TelemetryState* t = &s_src[pos];
+    (void)memset(t, 0, sizeof(*t));
+    t->sysid = sysid;
+    t->compid = compid;
+    LinkQuality_Init(&t->link);
+    s_index[slot] = (uint8_t)(pos + 1u);
+
+    return t;
+}
+
+static void Telemetry_CountMessage(const mavlink_message_t* msg, uint32_t now_ms, bool validated)
+{
+    // Update summary aggregator (log output happens in Telemetry_Update).
+    MavlinkSummary_OnMessage(&s_sum, msg);
+
+    // Unvalidated headers only update sources already known
+    TelemetryState* t;
+    if (validated)
+    {
+        t = Telemetry_Source(msg->sysid, msg->compid);
+    }
+    else
+    {
+        uint32_t slot = Telemetry_Probe(msg->sysid, msg->compid);
+        if (s_index[slot] == 0u)
+        {
+            return;
         }
+        t = &s_src[s_index[slot] - 1u];
+    }
 
-        default:
+    t->last_msg_ms = now_ms;
+    t->msg_count++;
+
+    // A corrupted seq would read as a jump (loss, duplicate, reorder), so
+    // an unvalidated frame may only confirm the seq that was expected.
+    if (validated || (msg->seq == t->link.next_seq))
+    {
+        LinkQuality_OnFrame(&t->link, msg->seq);
+    }
+}
+
+// Handlers read the few fields they need straight from the payload with the
+// generated mavlink_msg_*_get_*() accessors instead of decoding the whole
+// message onto the stack. MavlinkRx zero-fills MAVLink 2 truncated payloads
+// to the full length, so a trimmed field reads as 0, as with decode().
+static void Telemetry_OnHeartbeat(const mavlink_message_t* msg, uint32_t now_ms)
+{
+    TelemetryState* t = Telemetry_Source(msg->sysid, msg->compid);
+
+    t->last_hb_ms = now_ms;
+    t->hb_count++;
+
+    // MAV_MODE_FLAG_SAFETY_ARMED indicates "armed" state
+    t->armed = ((mavlink_msg_heartbeat_get_base_mode(msg) & MAV_MODE_FLAG_SAFETY_ARMED) != 0u);
+}
+
+static void Telemetry_OnSysStatus(const mavlink_message_t* msg, uint32_t now_ms)
+{
+    (void)now_ms;
+
+    TelemetryState* t = Telemetry_Source(msg->sysid, msg->compid);
+
+    // battery_voltage is in millivolts. UINT16_MAX means "unknown".
+    uint16_t voltage_mv = mavlink_msg_sys_status_get_voltage_battery(msg);
+    if (voltage_mv != UINT16_MAX)
+    {
+        t->has_battery = true;
+        t->battery_voltage_v = ((float)voltage_mv) * 0.001f;
+    }
+}
+
+static void Telemetry_OnGpsRawInt(const mavlink_message_t* msg, uint32_t now_ms)
+{
+    (void)now_ms;
+
+    TelemetryState* t = Telemetry_Source(msg->sysid, msg->compid);
+
+    t->has_gps = true;
+    t->gps_fix_type = mavlink_msg_gps_raw_int_get_fix_type(msg);
+    t->gps_sats_visible = mavlink_msg_gps_raw_int_get_satellites_visible(msg);
+}
+
+// Messages whose payload is decoded; everything else is only counted.
+static const TelemetryMsgHandler s_handlers[] =
+{
+    { MAVLINK_MSG_ID_HEARTBEAT,   Telemetry_OnHeartbeat },
+    { MAVLINK_MSG_ID_SYS_STATUS,  Telemetry_OnSysStatus },
+    { MAVLINK_MSG_ID_GPS_RAW_INT, Telemetry_OnGpsRawInt },
+};
+
+#define TELEMETRY_HANDLER_COUNT ((uint32_t)(sizeof(s_handlers) / sizeof(s_handlers[0])))
+
+void Telemetry_Init(void)
+{
+    (void)memset(s_src, 0, sizeof(s_src));
+    (void)memset(s_index, 0, sizeof(s_index));
+    s_src_count = 0u;
+    s_evictions = 0u;
+
+    // Log one summary line per second.
+    MavlinkSummary_Init(&s_sum, 1000u);
+}
+
+void Telemetry_OnMavlink(const mavlink_message_t* msg, uint32_t now_ms)
+{
+    if (msg == NULL)
+    {
+        return;
+    }
+
+    // Full messages (on_message / subscribers) are always CRC-checked
+    Telemetry_CountMessage(msg, now_ms, true);
+
+    for (uint32_t i = 0u; i < TELEMETRY_HANDLER_COUNT; i++)
+    {
+        if (s_handlers[i].msgid == msg->msgid)
         {
-            // Ignore other messages in MVP state tracking
+            s_handlers[i].fn(msg, now_ms);
             break;
         }
     }
 }
 
+void Telemetry_OnMavlinkHeader(const mavlink_message_t* msg, uint32_t now_ms, bool validated)
+{
+    if (msg == NULL)
+    {
+        return;
+    }
+
+    Telemetry_CountMessage(msg, now_ms, validated);
+}
+
+uint32_t Telemetry_GetMsgHandlers(const TelemetryMsgHandler** out_handlers)
+{
+    if (out_handlers != NULL)
+    {
+        *out_handlers = s_handlers;
+    }
+
+    return TELEMETRY_HANDLER_COUNT;
+}
+
 void Telemetry_Update(uint32_t now_ms)
 {
     // Emit compressed log once per second.
-    MavlinkSummary_UpdateAndLog(&s_sum, now_ms, &s_tlm);
+    MavlinkSummary_UpdateAndLog(&s_sum, now_ms, Telemetry_GetPrimary());
+}
+
+uint32_t Telemetry_GetSourceCount(void)
+{
+    return s_src_count;
+}
+
+const TelemetryState* Telemetry_GetSource(uint32_t index)
+{
+    return (index < s_src_count) ? &s_src[index] : NULL;
+}
+
+const TelemetryState* Telemetry_Find(uint8_t sysid, uint8_t compid)
+{
+    uint32_t slot = Telemetry_Probe(sysid, compid);
+    return (s_index[slot] != 0u) ? &s_src[s_index[slot] - 1u] : NULL;
+}
+
+const TelemetryState* Telemetry_GetPrimary(void)
+{
+    const TelemetryState* best = NULL;
+
+    for (uint32_t i = 0u; i < s_src_count; i++)
+    {
+        if ((best == NULL) || (s_src[i].msg_count > best->msg_count))
+        {
+            best = &s_src[i];
+        }
+    }
+
+    return best;
 }
 
-const TelemetryState* Telemetry_Get(void)
+uint32_t Telemetry_GetEvictions(void)
 {
-    return &s_tlm;
+    return s_evictions;
 }
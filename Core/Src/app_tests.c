@@ -1,6 +1,7 @@
 #include "app_tests.h"
 #include "logger.h"
 #include "stm32f4xx_hal.h"
+#include <string.h>
 
 void AppTests_Init(void)
 {
@@ -36,9 +37,936 @@ void AppTest_MavlinkRx_LogRxStatsOncePerSecond(const MavlinkRx* mav_rx)
     Logger_Write(
         LOG_LEVEL_INFO,
         "[TEST][MAV RX]",
-        "pushed=%lu dropped=%lu ovf=%lu",
+        "pushed=%lu dropped=%lu ovf=%lu lapped=%lu laps=%lu max_gap=%lums rec_dma=%lu restarts=%lu",
         (unsigned long)st.pushed_bytes,
         (unsigned long)st.dropped_bytes,
-        (unsigned long)st.overflow_events
+        (unsigned long)st.overflow_events,
+        (unsigned long)st.lapped_bytes,
+        (unsigned long)st.lap_events,
+        (unsigned long)st.max_poll_gap_ms,
+        (unsigned long)MavlinkRx_GetRecommendedDmaSize(mav_rx),
+        (unsigned long)st.rx_restarts
     );
 }
+
+void AppTest_MavlinkRx_LogParserStatsOncePerSecond(MavlinkRx* mav_rx)
+{
+    if (mav_rx == NULL)
+    {
+        return;
+    }
+
+    static uint32_t s_last_ms = 0u;
+    uint32_t now = HAL_GetTick();
+    if ((now - s_last_ms) < 1000u)
+    {
+        return;
+    }
+    s_last_ms = now;
+
+    MavlinkRx_Stats st;
+    MavlinkRx_GetStats(mav_rx, &st, 1u);
+
+    Logger_Write(
+        LOG_LEVEL_INFO,
+        "[TEST][MAV PARSE]",
+        "v1=%lu v2=%lu signed=%lu skipped=%lu recovered=%lu crc=%lu unknown=%lu len=%lu incompat=%lu sig=%lu discarded=%lu",
+        (unsigned long)st.frames_v1,
+        (unsigned long)st.frames_v2,
+        (unsigned long)st.frames_signed,
+        (unsigned long)st.frames_skipped,
+        (unsigned long)st.frames_recovered,
+        (unsigned long)st.bad_crc,
+        (unsigned long)st.unknown_msgid,
+        (unsigned long)st.bad_length,
+        (unsigned long)st.bad_incompat,
+        (unsigned long)st.bad_signature,
+        (unsigned long)st.bytes_discarded
+    );
+}
+
+#if UART_RX_RING_HISTOGRAMS
+void AppTest_MavlinkRx_LogRxHistogramsOncePerSecond(MavlinkRx* mav_rx)
+{
+    if (mav_rx == NULL)
+    {
+        return;
+    }
+
+    static uint32_t s_last_ms = 0u;
+    uint32_t now = HAL_GetTick();
+    if ((now - s_last_ms) < 1000u)
+    {
+        return;
+    }
+    s_last_ms = now;
+
+    // Snapshot and reset, so every line covers one window.
+    UartRxRing_Histograms h;
+    MavlinkRx_GetRxHistograms(mav_rx, &h, 1u);
+
+    // Buckets 0..11 cover up to 2047 bytes; enough for default buffer sizes.
+    Logger_Write(
+        LOG_LEVEL_INFO,
+        "[TEST][MAV RX HIST]",
+        "hw=%u n=%lu occ=%lu/%lu/%lu/%lu/%lu/%lu/%lu/%lu/%lu/%lu/%lu/%lu "
+        "poll=%lu/%lu/%lu/%lu/%lu/%lu/%lu/%lu/%lu/%lu/%lu/%lu",
+        (unsigned)h.high_water,
+        (unsigned long)h.samples,
+        (unsigned long)h.occupancy[0], (unsigned long)h.occupancy[1], (unsigned long)h.occupancy[2],
+        (unsigned long)h.occupancy[3], (unsigned long)h.occupancy[4], (unsigned long)h.occupancy[5],
+        (unsigned long)h.occupancy[6], (unsigned long)h.occupancy[7], (unsigned long)h.occupancy[8],
+        (unsigned long)h.occupancy[9], (unsigned long)h.occupancy[10], (unsigned long)h.occupancy[11],
+        (unsigned long)h.poll_bytes[0], (unsigned long)h.poll_bytes[1], (unsigned long)h.poll_bytes[2],
+        (unsigned long)h.poll_bytes[3], (unsigned long)h.poll_bytes[4], (unsigned long)h.poll_bytes[5],
+        (unsigned long)h.poll_bytes[6], (unsigned long)h.poll_bytes[7], (unsigned long)h.poll_bytes[8],
+        (unsigned long)h.poll_bytes[9], (unsigned long)h.poll_bytes[10], (unsigned long)h.poll_bytes[11]
+    );
+}
+#endif
+
+// Library shift/xor CRC step, kept here as the benchmark baseline
+static inline void AppTest_CrcBitwiseStep(uint8_t data, uint16_t* crc)
+{
+    uint8_t tmp = (uint8_t)(data ^ (uint8_t)(*crc & 0xFFu));
+    tmp ^= (uint8_t)(tmp << 4);
+    *crc = (uint16_t)((*crc >> 8) ^ ((uint16_t)tmp << 8) ^ ((uint16_t)tmp << 3) ^ (tmp >> 4));
+}
+
+void AppTest_MavlinkCrc_BenchmarkOnce(void)
+{
+    static uint8_t s_done = 0u;
+    if (s_done != 0u)
+    {
+        return;
+    }
+    s_done = 1u;
+
+    // MAVLink v2 max frame size, filled with pseudo-random bytes
+    static uint8_t buf[280];
+    uint32_t x = 0x12345678u;
+    for (uint32_t i = 0u; i < sizeof(buf); i++)
+    {
+        x = (x * 1664525u) + 1013904223u;
+        buf[i] = (uint8_t)(x >> 24);
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0u;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    uint16_t crc_bit = X25_INIT_CRC;
+    uint32_t t0 = DWT->CYCCNT;
+    for (uint32_t i = 0u; i < sizeof(buf); i++)
+    {
+        AppTest_CrcBitwiseStep(buf[i], &crc_bit);
+    }
+    uint32_t t1 = DWT->CYCCNT;
+
+    uint16_t crc_byte = X25_INIT_CRC;
+    for (uint32_t i = 0u; i < sizeof(buf); i++)
+    {
+        crc_accumulate(buf[i], &crc_byte);
+    }
+    uint32_t t2 = DWT->CYCCNT;
+
+    uint16_t crc_buf = X25_INIT_CRC;
+    MavlinkCrc_AccumulateBuffer(&crc_buf, buf, sizeof(buf));
+    uint32_t t3 = DWT->CYCCNT;
+
+    // Cycles per byte, x100
+    Logger_Write(
+        LOG_LEVEL_INFO,
+        "[TEST][MAV CRC]",
+        "impl=%d bytes=%u cpb_x100 bitwise=%lu accumulate=%lu buffer=%lu match=%d",
+        (int)MAVLINK_CRC_IMPL,
+        (unsigned)sizeof(buf),
+        (unsigned long)(((t1 - t0) * 100u) / sizeof(buf)),
+        (unsigned long)(((t2 - t1) * 100u) / sizeof(buf)),
+        (unsigned long)(((t3 - t2) * 100u) / sizeof(buf)),
+        (int)((crc_bit == crc_byte) && (crc_bit == crc_buf))
+    );
+}
+
+// The library's lookup: bisect the sorted dialect table
+static const mavlink_msg_entry_t* AppTest_MsgEntryBisect(const mavlink_msg_entry_t* tab, uint32_t count,
+                                                         uint32_t msgid)
+{
+    uint32_t low = 0u;
+    uint32_t high = count - 1u;
+    while (low < high)
+    {
+        uint32_t mid = (low + 1u + high) / 2u;
+        if (msgid < tab[mid].msgid)
+        {
+            high = mid - 1u;
+            continue;
+        }
+        if (msgid > tab[mid].msgid)
+        {
+            low = mid;
+            continue;
+        }
+        low = mid;
+        break;
+    }
+    return (tab[low].msgid == msgid) ? &tab[low] : NULL;
+}
+
+void AppTest_MavlinkMsgEntry_VerifyOnce(void)
+{
+    static uint8_t s_done = 0u;
+    if (s_done != 0u)
+    {
+        return;
+    }
+    s_done = 1u;
+
+    // Original dialect table, checked entry by entry. A trimmed table must
+    // return the dialect's entry or NULL.
+    static const mavlink_msg_entry_t s_ref[] = MAVLINK_MESSAGE_CRCS;
+    const uint32_t count = (uint32_t)(sizeof(s_ref) / sizeof(s_ref[0]));
+    const uint32_t expected = MavlinkMsgEntry_Count();
+    uint32_t bad = 0u;
+    uint32_t kept = 0u;
+    uint32_t found = 0u;
+
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        const mavlink_msg_entry_t* e = mavlink_get_msg_entry(s_ref[i].msgid);
+        if (e == NULL)
+        {
+            if (MavlinkMsgEntry_IsTrimmed() == 0u)
+            {
+                bad++;
+            }
+            continue;
+        }
+        kept++;
+        if (memcmp(e, &s_ref[i], sizeof(*e)) != 0)
+        {
+            bad++;
+        }
+    }
+
+    // Everything else in the 16-bit range must miss
+    for (uint32_t id = 0u; id <= 0xFFFFu; id++)
+    {
+        if (mavlink_get_msg_entry(id) != NULL)
+        {
+            found++;
+        }
+    }
+
+    // Lookup cost over the mix a link sees: kept ids and others
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0u;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    volatile uint32_t sink = 0u;
+    uint32_t t0 = DWT->CYCCNT;
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        sink += (uint32_t)(uintptr_t)AppTest_MsgEntryBisect(s_ref, count, s_ref[i].msgid);
+    }
+    uint32_t t1 = DWT->CYCCNT;
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        sink += (uint32_t)(uintptr_t)mavlink_get_msg_entry(s_ref[i].msgid);
+    }
+    uint32_t t2 = DWT->CYCCNT;
+    (void)sink;
+
+    Logger_Write(
+        LOG_LEVEL_INFO,
+        "[TEST][MAV ENTRY]",
+        "trimmed=%u entries=%lu/%lu bytes=%lu/%lu bad=%lu hits_16bit=%lu cyc_x10 bisect=%lu index=%lu %s",
+        (unsigned)MavlinkMsgEntry_IsTrimmed(),
+        (unsigned long)expected,
+        (unsigned long)count,
+        (unsigned long)(expected * sizeof(mavlink_msg_entry_t)),
+        (unsigned long)sizeof(s_ref),
+        (unsigned long)bad,
+        (unsigned long)found,
+        (unsigned long)(((t1 - t0) * 10u) / count),
+        (unsigned long)(((t2 - t1) * 10u) / count),
+        ((bad == 0u) && (kept == expected) && (found == expected)) ? "OK" : "FAIL"
+    );
+}
+
+void AppTest_MavlinkSign_BenchmarkOnce(void)
+{
+    static uint8_t s_done = 0u;
+    if (s_done != 0u)
+    {
+        return;
+    }
+    s_done = 1u;
+
+    static const uint8_t s_lens[4] = { 9u, 28u, 100u, 255u };
+    static MavlinkSign_KeyStore s_keys;
+    static MavlinkSign_Link s_link;
+    static mavlink_signing_t s_tx;
+    static mavlink_message_t s_msgs[8];
+    uint32_t cpf[4];
+    uint32_t ok = 0u;
+    uint32_t x = 0x12345678u;
+
+    uint8_t key[MAVLINK_SIGN_KEY_LEN];
+    for (uint32_t i = 0u; i < sizeof(key); i++)
+    {
+        key[i] = (uint8_t)(i * 7u + 1u);
+    }
+    MavlinkSign_KeyStoreInit(&s_keys);
+    (void)MavlinkSign_KeyStoreSet(&s_keys, 0u, key);
+    MavlinkSign_LinkInit(&s_link, &s_keys, 0u, 0u);
+
+    (void)memset(&s_tx, 0, sizeof(s_tx));
+    s_tx.flags = MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
+    s_tx.timestamp = 1u;
+    (void)memcpy(s_tx.secret_key, key, sizeof(key));
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0u;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    for (uint32_t l = 0u; l < 4u; l++)
+    {
+        const uint32_t count = (uint32_t)(sizeof(s_msgs) / sizeof(s_msgs[0]));
+
+        // Signed frames with increasing timestamps, as a sender would emit
+        for (uint32_t m = 0u; m < count; m++)
+        {
+            mavlink_message_t* msg = &s_msgs[m];
+            (void)memset(msg, 0, sizeof(*msg));
+            msg->magic = MAVLINK_STX;
+            msg->len = s_lens[l];
+            msg->incompat_flags = MAVLINK_IFLAG_SIGNED;
+            msg->seq = (uint8_t)m;
+            msg->sysid = 1u;
+            msg->compid = 1u;
+            for (uint32_t i = 0u; i < msg->len; i++)
+            {
+                x = (x * 1664525u) + 1013904223u;
+                _MAV_PAYLOAD_NON_CONST(msg)[i] = (char)(x >> 24);
+            }
+            (void)mavlink_sign_packet(&s_tx, msg->signature, &msg->magic, MAVLINK_NUM_HEADER_BYTES,
+                                      (const uint8_t*)_MAV_PAYLOAD(msg), msg->len, msg->ck);
+        }
+
+        uint32_t t0 = DWT->CYCCNT;
+        for (uint32_t m = 0u; m < count; m++)
+        {
+            if (MavlinkSign_Check(&s_link, &s_msgs[m], HAL_GetTick()) == MAVLINK_SIGN_OK)
+            {
+                ok++;
+            }
+        }
+        cpf[l] = (DWT->CYCCNT - t0) / count;
+    }
+
+    // CPU share in 0.01 % at 500 signed frames/s of the 28-byte size
+    uint32_t load_x100 = (uint32_t)(((uint64_t)cpf[1] * 500u * 10000u) / SystemCoreClock);
+
+    Logger_Write(
+        LOG_LEVEL_INFO,
+        "[TEST][MAV SIGN]",
+        "cycles/frame len9=%lu len28=%lu len100=%lu len255=%lu load_500hz=%lu.%02lu%% ok=%lu/32",
+        (unsigned long)cpf[0],
+        (unsigned long)cpf[1],
+        (unsigned long)cpf[2],
+        (unsigned long)cpf[3],
+        (unsigned long)(load_x100 / 100u),
+        (unsigned long)(load_x100 % 100u),
+        (unsigned long)ok
+    );
+}
+
+#if MAVLINK_RX_RESYNC
+static uint32_t s_resync_test_seed = 12345u;
+
+// Small LCG: repeatable noise without pulling in rand()
+static uint32_t AppTest_NoiseNext(void)
+{
+    s_resync_test_seed = (s_resync_test_seed * 1103515245u) + 12345u;
+    return (s_resync_test_seed >> 8);
+}
+
+static void AppTest_CountFrame(void* ctx, const mavlink_message_t* msg)
+{
+    (void)msg;
+    (*(uint32_t*)ctx)++;
+}
+
+void AppTest_MavlinkRx_ResyncNoiseOnce(void)
+{
+    static uint8_t s_done = 0u;
+    if (s_done != 0u)
+    {
+        return;
+    }
+    s_done = 1u;
+
+    static MavlinkRx s_plain;
+    static MavlinkRx s_resync;
+    static uint8_t s_ring[2][2][64];
+    static uint8_t s_frame[MAVLINK_MAX_PACKET_LEN];
+    const uint32_t frames = 2000u;
+    uint32_t got_plain = 0u;
+    uint32_t got_resync = 0u;
+    uint32_t damaged = 0u;
+
+    MavlinkRx_InitWithBuffers(&s_plain, NULL, s_ring[0][0], 64u, s_ring[0][1], 64u);
+    MavlinkRx_InitWithBuffers(&s_resync, NULL, s_ring[1][0], 64u, s_ring[1][1], 64u);
+    MavlinkRx_SetOnMessage(&s_plain, AppTest_CountFrame, &got_plain);
+    MavlinkRx_SetOnMessage(&s_resync, AppTest_CountFrame, &got_resync);
+    MavlinkRx_SetResync(&s_resync, true);
+
+    // Pack on a test channel so the app's TX sequence is left alone
+    uint8_t chan = MavlinkRx_GetChannel(&s_plain);
+    if (chan == MAVLINK_RX_NO_CHANNEL)
+    {
+        Logger_Write(LOG_LEVEL_WARN, "[TEST][MAV RESYNC]", "no free channel");
+        MavlinkRx_ReleaseChannel(&s_resync);
+        return;
+    }
+
+    for (uint32_t i = 0u; i < frames; i++)
+    {
+        mavlink_message_t msg;
+        uint32_t r = AppTest_NoiseNext();
+
+        if ((r & 1u) != 0u)
+        {
+            mavlink_msg_attitude_pack_chan(1u, 1u, chan, &msg, i, 0.1f, 0.2f, 0.3f,
+                                           (float)r, 0.0f, 0.0f);
+        }
+        else
+        {
+            mavlink_msg_heartbeat_pack_chan(1u, 1u, chan, &msg, MAV_TYPE_QUADROTOR,
+                                            MAV_AUTOPILOT_PX4, 0u, r, MAV_STATE_ACTIVE);
+        }
+        uint16_t n = mavlink_msg_to_send_buffer(s_frame, &msg);
+
+        // ~6% lose a run of 1..8 bytes (radio drop), ~3% get a byte flipped
+        r = AppTest_NoiseNext();
+        if ((r % 100u) < 6u)
+        {
+            uint16_t at = (uint16_t)(AppTest_NoiseNext() % n);
+            uint16_t cnt = (uint16_t)(1u + (AppTest_NoiseNext() % 8u));
+            if ((uint32_t)at + cnt > n)
+            {
+                cnt = (uint16_t)(n - at);
+            }
+            (void)memmove(&s_frame[at], &s_frame[at + cnt], (size_t)(n - at - cnt));
+            n = (uint16_t)(n - cnt);
+            damaged++;
+        }
+        else if ((r % 100u) < 9u)
+        {
+            s_frame[AppTest_NoiseNext() % n] ^= (uint8_t)(1u + (AppTest_NoiseNext() % 255u));
+            damaged++;
+        }
+
+        (void)MavlinkRx_ParseSpan(&s_plain, s_frame, n);
+        (void)MavlinkRx_ParseSpan(&s_resync, s_frame, n);
+    }
+
+    // One-shot: give both channels back to the app
+    MavlinkRx_ReleaseChannel(&s_plain);
+    MavlinkRx_ReleaseChannel(&s_resync);
+
+    Logger_Write(
+        LOG_LEVEL_INFO,
+        "[TEST][MAV RESYNC]",
+        "frames=%lu damaged=%lu plain=%lu resync=%lu recovered=%lu",
+        (unsigned long)frames,
+        (unsigned long)damaged,
+        (unsigned long)got_plain,
+        (unsigned long)got_resync,
+        (unsigned long)(got_resync - got_plain)
+    );
+}
+#endif
+
+// Reference frames from mavlink_parse_char(), waiting for MavlinkRx
+typedef struct
+{
+    mavlink_message_t msgs[4];
+    uint8_t head;
+    uint8_t count;
+    uint32_t matched;
+    uint32_t signed_matched;
+    uint32_t bad;
+} AppTest_DiffQueue;
+
+static uint32_t AppTest_DiffNext(uint32_t* x)
+{
+    *x = (*x * 1664525u) + 1013904223u;
+    return (*x >> 8);
+}
+
+// Same frame, field by field: header, checksum, payload up to the larger of
+// len and the dialect length (truncated v2 payloads are zero-filled), and
+// the signature when present.
+static bool AppTest_DiffSame(const mavlink_message_t* a, const mavlink_message_t* b)
+{
+    const mavlink_msg_entry_t* e = mavlink_get_msg_entry(a->msgid);
+    uint32_t plen = a->len;
+    if ((e != NULL) && (e->max_msg_len > plen))
+    {
+        plen = e->max_msg_len;
+    }
+
+    if ((a->magic != b->magic) || (a->len != b->len) || (a->incompat_flags != b->incompat_flags) ||
+        (a->seq != b->seq) || (a->sysid != b->sysid) || (a->compid != b->compid) ||
+        (a->msgid != b->msgid) || (a->checksum != b->checksum))
+    {
+        return false;
+    }
+    if (memcmp(_MAV_PAYLOAD(a), _MAV_PAYLOAD(b), plen) != 0)
+    {
+        return false;
+    }
+    if (((a->incompat_flags & MAVLINK_IFLAG_SIGNED) != 0u) &&
+        (memcmp(a->signature, b->signature, MAVLINK_SIGNATURE_BLOCK_LEN) != 0))
+    {
+        return false;
+    }
+    return true;
+}
+
+static void AppTest_DiffOnFrame(void* ctx, const mavlink_message_t* msg)
+{
+    AppTest_DiffQueue* q = (AppTest_DiffQueue*)ctx;
+    if (q->count == 0u)
+    {
+        q->bad++; // delivered a frame the reference parser rejected
+        return;
+    }
+
+    if (AppTest_DiffSame(&q->msgs[q->head], msg))
+    {
+        q->matched++;
+        if ((msg->incompat_flags & MAVLINK_IFLAG_SIGNED) != 0u)
+        {
+            q->signed_matched++;
+        }
+    }
+    else
+    {
+        q->bad++;
+    }
+    q->head = (uint8_t)((q->head + 1u) % 4u);
+    q->count--;
+}
+
+// Signed pass: unsigned frames are only let through for HEARTBEAT
+static bool AppTest_DiffAcceptUnsigned(const mavlink_status_t* status, uint32_t msgid)
+{
+    (void)status;
+    return (msgid == MAVLINK_MSG_ID_HEARTBEAT);
+}
+
+// One pass of the differential check. With signing, ~70% of the v2 frames
+// are signed and both parsers verify them with the same key, each with its
+// own replay state.
+static void AppTest_DiffPass(bool signing)
+{
+    // Known ids of several sizes, v1-capable and not, plus one without a
+    // CRC_EXTRA entry (rejected by both with MAVLINK_RX_ACCEPT_UNKNOWN 0).
+    static const uint32_t s_ids[] = { 0u, 1u, 24u, 30u, 33u, 74u, 147u, 253u, 242u, 245u, 22u, 65u,
+                                      12915u, 77777u };
+    static MavlinkRx s_ref;
+    static MavlinkRx s_rx;
+    static AppTest_DiffQueue s_q;
+    static uint8_t s_ring[2][2][64];
+    static uint8_t s_buf[MAVLINK_MAX_PACKET_LEN + 40u];
+    static mavlink_signing_t s_tx_sign;
+    static mavlink_signing_t s_rx_sign[2];
+    static mavlink_signing_streams_t s_rx_streams[2];
+    const uint32_t frames = 3000u;
+    uint32_t x = signing ? 0x1357ACE1u : 0x2468ACE1u;
+    uint32_t signed_frames = 0u;
+    mavlink_status_t tx;
+    mavlink_status_t rs;
+
+    // s_ref is never fed: it only claims a channel for mavlink_parse_char()
+    MavlinkRx_InitWithBuffers(&s_ref, NULL, s_ring[0][0], 64u, s_ring[0][1], 64u);
+    MavlinkRx_InitWithBuffers(&s_rx, NULL, s_ring[1][0], 64u, s_ring[1][1], 64u);
+    (void)memset(&s_q, 0, sizeof(s_q));
+    MavlinkRx_SetOnMessage(&s_rx, AppTest_DiffOnFrame, &s_q);
+    uint8_t chan = MavlinkRx_GetChannel(&s_ref);
+    uint8_t rx_chan = MavlinkRx_GetChannel(&s_rx);
+    if ((chan == MAVLINK_RX_NO_CHANNEL) || (rx_chan == MAVLINK_RX_NO_CHANNEL))
+    {
+        Logger_Write(LOG_LEVEL_WARN, "[TEST][MAV DIFF]", "no free channel");
+        MavlinkRx_ReleaseChannel(&s_ref);
+        MavlinkRx_ReleaseChannel(&s_rx);
+        return;
+    }
+
+    (void)memset(&s_tx_sign, 0, sizeof(s_tx_sign));
+    for (uint32_t i = 0u; i < sizeof(s_tx_sign.secret_key); i++)
+    {
+        s_tx_sign.secret_key[i] = (uint8_t)(i * 7u + 1u);
+    }
+    s_tx_sign.flags = MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
+    s_tx_sign.timestamp = 1000u;
+
+    if (signing)
+    {
+        for (uint32_t k = 0u; k < 2u; k++)
+        {
+            (void)memset(&s_rx_sign[k], 0, sizeof(s_rx_sign[k]));
+            (void)memcpy(s_rx_sign[k].secret_key, s_tx_sign.secret_key, sizeof(s_tx_sign.secret_key));
+            s_rx_sign[k].accept_unsigned_callback = AppTest_DiffAcceptUnsigned;
+            (void)memset(&s_rx_streams[k], 0, sizeof(s_rx_streams[k]));
+        }
+        mavlink_get_channel_status(chan)->signing = &s_rx_sign[0];
+        mavlink_get_channel_status(chan)->signing_streams = &s_rx_streams[0];
+        mavlink_get_channel_status(rx_chan)->signing = &s_rx_sign[1];
+        mavlink_get_channel_status(rx_chan)->signing_streams = &s_rx_streams[1];
+    }
+
+    (void)memset(&tx, 0, sizeof(tx));
+    for (uint32_t f = 0u; f < frames; f++)
+    {
+        mavlink_message_t msg;
+        (void)memset(&msg, 0, sizeof(msg));
+
+        uint32_t id = s_ids[AppTest_DiffNext(&x) % (sizeof(s_ids) / sizeof(s_ids[0]))];
+        const mavlink_msg_entry_t* e = mavlink_get_msg_entry(id);
+        uint8_t min_len = (e != NULL) ? e->min_msg_len : (uint8_t)(AppTest_DiffNext(&x) % 50u);
+        uint8_t max_len = (e != NULL) ? e->max_msg_len : (uint8_t)(min_len + (AppTest_DiffNext(&x) % 10u));
+        uint8_t crc_extra = (e != NULL) ? e->crc_extra : (uint8_t)AppTest_DiffNext(&x);
+
+        // Random payloads with trailing zeros (v2 truncation), and ~20% made
+        // of STX bytes to tempt the framing
+        uint8_t* pl = (uint8_t*)_MAV_PAYLOAD_NON_CONST(&msg);
+        uint32_t nz = AppTest_DiffNext(&x) % ((uint32_t)max_len + 1u);
+        bool stx = (AppTest_DiffNext(&x) % 5u) == 0u;
+        for (uint32_t i = 0u; i < max_len; i++)
+        {
+            uint32_t r = AppTest_DiffNext(&x);
+            if (stx)
+            {
+                pl[i] = ((r & 1u) != 0u) ? MAVLINK_STX : MAVLINK_STX_MAVLINK1;
+            }
+            else
+            {
+                pl[i] = (i < nz) ? (uint8_t)r : 0u;
+            }
+        }
+
+        msg.msgid = id;
+        bool v1 = (id < 256u) && ((AppTest_DiffNext(&x) % 4u) == 0u);
+        tx.flags = v1 ? MAVLINK_STATUS_FLAG_OUT_MAVLINK1 : 0u;
+        tx.signing = (signing && !v1 && ((AppTest_DiffNext(&x) % 10u) < 7u)) ? &s_tx_sign : NULL;
+        (void)mavlink_finalize_message_buffer(&msg, (uint8_t)(1u + (AppTest_DiffNext(&x) % 3u)),
+                                              (uint8_t)(1u + (AppTest_DiffNext(&x) % 2u)), &tx,
+                                              min_len, max_len, crc_extra);
+        uint16_t n = mavlink_msg_to_send_buffer(s_buf, &msg);
+        bool is_signed = (msg.incompat_flags & MAVLINK_IFLAG_SIGNED) != 0u;
+        if (is_signed)
+        {
+            signed_frames++;
+        }
+
+        // ~6% bit flip, ~2% truncated, ~1% bad len, ~1% unknown incompat flag;
+        // signed frames also get ~3% a bad CRC byte and ~3% a bad signature byte
+        uint32_t r = AppTest_DiffNext(&x) % 100u;
+        if (r < 6u)
+        {
+            s_buf[AppTest_DiffNext(&x) % n] ^= (uint8_t)(1u << (AppTest_DiffNext(&x) % 8u));
+        }
+        else if (r < 8u)
+        {
+            n = (uint16_t)(AppTest_DiffNext(&x) % n);
+        }
+        else if (r < 9u)
+        {
+            s_buf[1] = (uint8_t)AppTest_DiffNext(&x);
+        }
+        else if ((r < 10u) && !v1)
+        {
+            s_buf[2] |= 0x02u;
+        }
+        else if ((r < 13u) && is_signed)
+        {
+            s_buf[n - MAVLINK_SIGNATURE_BLOCK_LEN - 2u + (AppTest_DiffNext(&x) % 2u)] ^=
+                (uint8_t)(1u << (AppTest_DiffNext(&x) % 8u));
+        }
+        else if ((r < 16u) && is_signed)
+        {
+            s_buf[n - MAVLINK_SIGNATURE_BLOCK_LEN + (AppTest_DiffNext(&x) % MAVLINK_SIGNATURE_BLOCK_LEN)] ^=
+                (uint8_t)(1u << (AppTest_DiffNext(&x) % 8u));
+        }
+
+        // ~5% trailing noise, biased towards STX
+        if ((AppTest_DiffNext(&x) % 20u) == 0u)
+        {
+            uint32_t g = AppTest_DiffNext(&x) % 40u;
+            for (uint32_t i = 0u; i < g; i++)
+            {
+                uint32_t v = AppTest_DiffNext(&x);
+                s_buf[n++] = ((v % 8u) == 0u) ? MAVLINK_STX : (uint8_t)(v >> 4);
+            }
+        }
+
+        // Reference first (byte by byte), then MavlinkRx in random spans
+        for (uint16_t i = 0u; i < n; i++)
+        {
+            mavlink_message_t out;
+            if (mavlink_parse_char(chan, s_buf[i], &out, &rs) != 0u)
+            {
+                if (s_q.count < 4u)
+                {
+                    s_q.msgs[(s_q.head + s_q.count) % 4u] = out;
+                    s_q.count++;
+                }
+                else
+                {
+                    s_q.bad++;
+                }
+            }
+        }
+
+        uint16_t p = 0u;
+        while (p < n)
+        {
+            uint16_t c = (uint16_t)(1u + (AppTest_DiffNext(&x) % 64u));
+            if (c > (uint16_t)(n - p))
+            {
+                c = (uint16_t)(n - p);
+            }
+            (void)MavlinkRx_ParseSpan(&s_rx, &s_buf[p], c);
+            p = (uint16_t)(p + c);
+        }
+
+        // Anything still queued was never delivered by MavlinkRx
+        s_q.bad += s_q.count;
+        s_q.count = 0u;
+    }
+
+    // One-shot: give both channels back to the app
+    MavlinkRx_ReleaseChannel(&s_ref);
+    MavlinkRx_ReleaseChannel(&s_rx);
+
+    // A signed pass that verified no signed frame proves nothing
+    bool ok = (s_q.bad == 0u) && (!signing || (s_q.signed_matched != 0u));
+    Logger_Write(
+        LOG_LEVEL_INFO,
+        "[TEST][MAV DIFF]",
+        "sign=%u frames=%lu signed=%lu ok_ref=%u ok_rx=%u matched=%lu signed_matched=%lu bad=%lu %s",
+        (unsigned)signing,
+        (unsigned long)frames,
+        (unsigned long)signed_frames,
+        (unsigned)s_ref.mav_status.packet_rx_success_count,
+        (unsigned)s_rx.mav_status.packet_rx_success_count,
+        (unsigned long)s_q.matched,
+        (unsigned long)s_q.signed_matched,
+        (unsigned long)s_q.bad,
+        ok ? "MATCH" : "FAIL"
+    );
+}
+
+void AppTest_MavlinkRx_DiffParseCharOnce(void)
+{
+    static uint8_t s_done = 0u;
+    if (s_done != 0u)
+    {
+        return;
+    }
+    s_done = 1u;
+
+    // No signing on either side, then the same key on both
+    AppTest_DiffPass(false);
+    AppTest_DiffPass(true);
+}
+
+#if APP_TEST_SPSC_STRESS
+// SPSC stress: a TIM2 interrupt is the producer (fake DMA writes +
+// PollFromDma()), the main loop the consumer. Both sides run the same LCG byte stream, so
+// any lost, duplicated or torn byte shows up as a mismatch.
+static UartRxRing s_spsc_ring;
+static UART_HandleTypeDef s_spsc_huart;
+static DMA_HandleTypeDef s_spsc_hdma;
+static DMA_Stream_TypeDef s_spsc_stream; // only NDTR is used, plain RAM
+static uint8_t s_spsc_dma[64];
+static uint8_t s_spsc_sw[128];
+static volatile uint8_t s_spsc_active = 0u;
+static volatile uint32_t s_spsc_consumed = 0u;
+static uint32_t s_spsc_produced = 0u;
+static uint32_t s_spsc_polls = 0u;
+static uint16_t s_spsc_wpos = 0u;
+static uint32_t s_spsc_tx_x = 0x13579BDFu;
+static uint32_t s_spsc_size_x = 0x0F1E2D3Cu;
+
+static uint8_t AppTest_SpscByte(uint32_t* x)
+{
+    *x = (*x * 1664525u) + 1013904223u;
+    return (uint8_t)(*x >> 24);
+}
+
+// Producer, TIM2 context: a random burst that fits both the DMA buffer
+// (no lap) and the SW ring (no drop), then publish it.
+static void AppTest_SpscProduce(void)
+{
+    uint32_t room = (uint32_t)(sizeof(s_spsc_sw) - 1u) - (s_spsc_produced - s_spsc_consumed);
+    s_spsc_size_x = (s_spsc_size_x * 1664525u) + 1013904223u;
+    uint32_t k = 1u + ((s_spsc_size_x >> 8) % (sizeof(s_spsc_dma) - 1u));
+    if (k > room)
+    {
+        k = room;
+    }
+
+    for (uint32_t i = 0u; i < k; i++)
+    {
+        s_spsc_dma[s_spsc_wpos] = AppTest_SpscByte(&s_spsc_tx_x);
+        s_spsc_wpos = (uint16_t)((s_spsc_wpos + 1u) % sizeof(s_spsc_dma));
+    }
+    s_spsc_produced += k;
+
+    s_spsc_stream.NDTR = (uint32_t)(sizeof(s_spsc_dma) - s_spsc_wpos);
+    UartRxRing_PollFromDma(&s_spsc_ring);
+    s_spsc_polls++;
+}
+
+// Owned by the test while APP_TEST_SPSC_STRESS is set (the startup file
+// only has a weak default for it).
+void TIM2_IRQHandler(void)
+{
+    TIM2->SR = ~(uint32_t)TIM_SR_UIF;
+    if (s_spsc_active != 0u)
+    {
+        AppTest_SpscProduce();
+    }
+}
+
+// TIM2 update interrupt at ~20 kHz, so the producer lands at many
+// different points of the consumer loop.
+static void AppTest_SpscTimerStart(void)
+{
+    uint32_t clk = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+    {
+        clk *= 2u; // APB1 timers run at 2x PCLK1 when APB1 is divided
+    }
+
+    __HAL_RCC_TIM2_CLK_ENABLE();
+    TIM2->CR1 = 0u;
+    TIM2->PSC = (clk / 1000000u) - 1u;
+    TIM2->ARR = 50u - 1u;
+    TIM2->EGR = TIM_EGR_UG;
+    TIM2->SR = 0u;
+    TIM2->DIER = TIM_DIER_UIE;
+    HAL_NVIC_SetPriority(TIM2_IRQn, 5u, 0u);
+    HAL_NVIC_EnableIRQ(TIM2_IRQn);
+    TIM2->CR1 = TIM_CR1_CEN;
+}
+
+static void AppTest_SpscTimerStop(void)
+{
+    TIM2->CR1 = 0u;
+    TIM2->DIER = 0u;
+    HAL_NVIC_DisableIRQ(TIM2_IRQn);
+    TIM2->SR = 0u;
+    HAL_NVIC_ClearPendingIRQ(TIM2_IRQn);
+    __HAL_RCC_TIM2_CLK_DISABLE();
+}
+
+void AppTest_UartRxRing_SpscStressOnce(void)
+{
+    static uint8_t s_done = 0u;
+    if (s_done != 0u)
+    {
+        return;
+    }
+    s_done = 1u;
+
+    const uint32_t duration_ms = 2000u;
+    uint32_t rx_x = s_spsc_tx_x;
+    uint32_t pick_x = 0xCAFEF00Du;
+    uint32_t got = 0u;
+    uint32_t bad = 0u;
+    uint8_t tmp[48];
+
+    s_spsc_stream.NDTR = sizeof(s_spsc_dma);
+    s_spsc_hdma.Instance = &s_spsc_stream;
+    s_spsc_huart.hdmarx = &s_spsc_hdma;
+    UartRxRing_InitWithBuffers(&s_spsc_ring, &s_spsc_huart, s_spsc_dma, (uint16_t)sizeof(s_spsc_dma),
+                               s_spsc_sw, (uint16_t)sizeof(s_spsc_sw));
+
+    uint32_t start = HAL_GetTick();
+    s_spsc_active = 1u;
+    AppTest_SpscTimerStart();
+
+    // Consumer: alternate zero-copy Peek()/partial Commit() and Read()
+    // until the producer has stopped and the ring is drained.
+    for (;;)
+    {
+        if ((s_spsc_active != 0u) && ((HAL_GetTick() - start) >= duration_ms))
+        {
+            s_spsc_active = 0u;
+            AppTest_SpscTimerStop();
+        }
+
+        uint16_t n = 0u;
+        pick_x = (pick_x * 1664525u) + 1013904223u;
+        if (((pick_x >> 16) & 1u) != 0u)
+        {
+            UartRxRing_Span a;
+            UartRxRing_Span b;
+            uint16_t avail = UartRxRing_Peek(&s_spsc_ring, &a, &b);
+            n = (uint16_t)((pick_x >> 20) % ((uint32_t)avail + 1u));
+            for (uint16_t i = 0u; i < n; i++)
+            {
+                uint8_t v = (i < a.len) ? a.data[i] : b.data[i - a.len];
+                if (v != AppTest_SpscByte(&rx_x))
+                {
+                    bad++;
+                }
+            }
+            UartRxRing_Commit(&s_spsc_ring, n);
+        }
+        else
+        {
+            n = UartRxRing_Read(&s_spsc_ring, tmp, (uint16_t)(1u + ((pick_x >> 20) % sizeof(tmp))));
+            for (uint16_t i = 0u; i < n; i++)
+            {
+                if (tmp[i] != AppTest_SpscByte(&rx_x))
+                {
+                    bad++;
+                }
+            }
+        }
+
+        got += n;
+        s_spsc_consumed = got;
+
+        if ((s_spsc_active == 0u) && (UartRxRing_Available(&s_spsc_ring) == 0u))
+        {
+            break;
+        }
+    }
+
+    UartRxRing_Stats st;
+    UartRxRing_GetStats(&s_spsc_ring, &st);
+    bool ok = (bad == 0u) && (got == s_spsc_produced) && (st.dropped_bytes == 0u) && (st.lapped_bytes == 0u);
+
+    Logger_Write(
+        LOG_LEVEL_INFO,
+        "[TEST][SPSC]",
+        "ms=%lu polls=%lu produced=%lu consumed=%lu bad=%lu dropped=%lu lapped=%lu %s",
+        (unsigned long)duration_ms,
+        (unsigned long)s_spsc_polls,
+        (unsigned long)s_spsc_produced,
+        (unsigned long)got,
+        (unsigned long)bad,
+        (unsigned long)st.dropped_bytes,
+        (unsigned long)st.lapped_bytes,
+        ok ? "OK" : "FAIL"
+    );
+}
+#endif
@@ -3,6 +3,19 @@
 #include <string.h>
 #include "logger.h"
 
+#if UART_RX_RING_SPSC
+// SPSC mode: producer owns sw_head, consumer owns sw_tail. Ordering is
+// provided by the acquire/release helpers below, so no IRQ masking.
+static uint32_t UartRxRing_EnterCritical(void)
+{
+    return 0u;
+}
+
+static void UartRxRing_ExitCritical(uint32_t primask)
+{
+    (void)primask;
+}
+#else
 // Critical section: protects SW ring indices and stats vs ISR.
 // For this stage, we use IRQ disable (simple, reliable).
 static uint32_t UartRxRing_EnterCritical(void)
@@ -16,76 +29,408 @@ static void UartRxRing_ExitCritical(uint32_t primask)
 {
     __set_PRIMASK(primask);
 }
+#endif
+
+#if !UART_RX_RING_DIRECT_DMA
+// Index publication between producer and consumer.
+// Acquire: read the other side's index before touching the data it guards.
+// Release: finish all data accesses before publishing our own index.
+// __DMB() is also a compiler barrier, which is what matters on a single core.
+static uint16_t UartRxRing_LoadAcquire(const volatile uint16_t* idx)
+{
+    uint16_t v = *idx;
+    __DMB();
+    return v;
+}
+
+static void UartRxRing_StoreRelease(volatile uint16_t* idx, uint16_t v)
+{
+    __DMB();
+    *idx = v;
+}
+
+// Index wraparound uses (sw_size - 1) as a mask instead of a division.
+// Caller-provided sizes are checked in UartRxRing_InitWithBuffers().
+_Static_assert((UART_RX_RING_SW_BUF_SIZE & (UART_RX_RING_SW_BUF_SIZE - 1u)) == 0u,
+               "UART_RX_RING_SW_BUF_SIZE must be a power of two");
+
+static uint16_t UartRxRing_SwMask(const UartRxRing* ring)
+{
+    return (uint16_t)(ring->sw_size - 1u);
+}
 
 static uint16_t UartRxRing_SwFreeSpace_NoLock(const UartRxRing* ring)
+{
+    // Keep one byte empty to distinguish full vs empty.
+    uint16_t tail = UartRxRing_LoadAcquire(&ring->sw_tail);
+    return (uint16_t)((tail - ring->sw_head - 1u) & UartRxRing_SwMask(ring));
+}
+
+// Copies len bytes into SW ring at head (caller guarantees enough free space).
+// At most two memcpy calls: up to the end of sw_buf, then from index 0.
+static void UartRxRing_SwWrite_NoLock(UartRxRing* ring, const uint8_t* src, uint16_t len)
 {
     uint16_t head = ring->sw_head;
+    uint16_t to_end = (uint16_t)(ring->sw_size - head);
+    uint16_t first = (len < to_end) ? len : to_end;
+
+    (void)memcpy(&ring->sw_buf[head], src, first);
+    if (len > first)
+    {
+        (void)memcpy(&ring->sw_buf[0], &src[first], (size_t)(len - first));
+    }
+
+    UartRxRing_StoreRelease(&ring->sw_head, (uint16_t)((head + len) & UartRxRing_SwMask(ring)));
+}
+#else
+// Direct mode: consumer reads dma_buf[dma_read_pos..dma_last_pos) in place.
+// Same one-byte-empty convention as the SW ring, but dma_size need not be a
+// power of two, so no masking here.
+static uint16_t UartRxRing_DmaAvail(const UartRxRing* ring)
+{
+    uint16_t last = ring->dma_last_pos;
+    uint16_t read = ring->dma_read_pos;
+    return (last >= read) ? (uint16_t)(last - read) : (uint16_t)(ring->dma_size - read + last);
+}
+#endif
+
+#if !UART_RX_RING_DIRECT_DMA && (UART_RX_RING_DROP_POLICY != UART_RX_RING_DROP_BYTES)
+static uint8_t UartRxRing_IsStx(uint8_t b)
+{
+    return (b == UART_RX_RING_STX_V1 || b == UART_RX_RING_STX_V2) ? 1u : 0u;
+}
+
+// Byte `off` of the new DMA region that starts at `last`.
+static uint8_t UartRxRing_DmaByteAt(const UartRxRing* ring, uint16_t last, uint16_t off)
+{
+    uint32_t i = (uint32_t)last + off;
+    if (i >= ring->dma_size)
+    {
+        i -= ring->dma_size;
+    }
+    return ring->dma_buf[i];
+}
+
+static uint32_t UartRxRing_CountStx(const UartRxRing* ring, uint16_t last, uint16_t from, uint16_t to)
+{
+    uint32_t n = 0u;
+    for (uint16_t i = from; i < to; i++)
+    {
+        n += UartRxRing_IsStx(UartRxRing_DmaByteAt(ring, last, i));
+    }
+    return n;
+}
+#endif
+
+#if !UART_RX_RING_DIRECT_DMA && (UART_RX_RING_DROP_POLICY == UART_RX_RING_DROP_NEWEST_FRAME)
+// Picks which part of the new DMA region [0..moved) goes into the SW ring so
+// that only whole frames are dropped: the kept part ends right before an STX,
+// and after a drop everything up to the next STX (rest of that frame) is
+// skipped as well. Returns bytes to copy; *out_off is where they start.
+static uint16_t UartRxRing_SelectNewestFrame(UartRxRing* ring, uint16_t last, uint16_t moved,
+                                             uint16_t free_space, uint16_t* out_off,
+                                             uint32_t* drop_frames)
+{
+    uint16_t start = 0u;
+
+    if (ring->drop_until_stx != 0u)
+    {
+        while (start < moved && UartRxRing_IsStx(UartRxRing_DmaByteAt(ring, last, start)) == 0u)
+        {
+            start++;
+        }
+        if (start < moved)
+        {
+            ring->drop_until_stx = 0u;
+        }
+    }
+
+    *out_off = start;
+
+    uint16_t len = (uint16_t)(moved - start);
+    if (len <= free_space)
+    {
+        return len;
+    }
+
+    // Cut at the last STX such that [start..cut) fits.
+    uint16_t cut = (uint16_t)(start + free_space);
+    while (cut > start && UartRxRing_IsStx(UartRxRing_DmaByteAt(ring, last, cut)) == 0u)
+    {
+        cut--;
+    }
+
+    *drop_frames += UartRxRing_CountStx(ring, last, cut, moved);
+    if (UartRxRing_IsStx(UartRxRing_DmaByteAt(ring, last, cut)) == 0u)
+    {
+        (*drop_frames)++; // frame in flight at `start` is cut as well
+    }
+
+    ring->drop_until_stx = 1u;
+    return (uint16_t)(cut - start);
+}
+#endif
+
+#if !UART_RX_RING_DIRECT_DMA && (UART_RX_RING_DROP_POLICY == UART_RX_RING_DROP_OLDEST_FRAME)
+// Discards whole frames from the SW ring tail (up to the next STX each) until
+// `needed` bytes fit or the ring is empty. Returns the new free space.
+static uint16_t UartRxRing_MakeRoomOldestFrame(UartRxRing* ring, uint16_t needed, uint16_t free_space,
+                                               uint32_t* drop_bytes, uint32_t* drop_frames)
+{
+    uint16_t mask = UartRxRing_SwMask(ring);
     uint16_t tail = ring->sw_tail;
+    uint16_t avail = (uint16_t)((ring->sw_head - tail) & mask);
+    uint16_t discard = 0u;
 
-    // Keep one byte empty to distinguish full vs empty.
-    if (head >= tail)
+    while ((uint32_t)free_space + discard < needed && discard < avail)
     {
-        return (uint16_t)(ring->sw_size - (head - tail) - 1u);
+        (*drop_frames)++;
+        discard++;
+        while (discard < avail && UartRxRing_IsStx(ring->sw_buf[(tail + discard) & mask]) == 0u)
+        {
+            discard++;
+        }
     }
-    else
+
+    if (discard != 0u)
     {
-        return (uint16_t)((tail - head) - 1u);
+        UartRxRing_StoreRelease(&ring->sw_tail, (uint16_t)((tail + discard) & mask));
+        *drop_bytes += discard;
     }
+
+    return (uint16_t)(free_space + discard);
 }
+#endif
+
+// Default storage for UartRxRing_Init() (single instance).
+static uint8_t s_default_dma_buf[UART_RX_RING_DMA_BUF_SIZE];
+#if !UART_RX_RING_DIRECT_DMA
+static uint8_t s_default_sw_buf[UART_RX_RING_SW_BUF_SIZE];
+#endif
+static UartRxRing* s_default_owner = NULL;
 
-static void UartRxRing_SwPushByte_NoLock(UartRxRing* ring, uint8_t b)
+void UartRxRing_Init(UartRxRing* ring, UART_HandleTypeDef* huart)
 {
-    uint16_t free_space = UartRxRing_SwFreeSpace_NoLock(ring);
-    if (free_space == 0u)
+    if (ring == NULL)
     {
-        ring->overflow_events++;
-        ring->dropped_bytes++;
         return;
     }
 
-    ring->sw_buf[ring->sw_head] = b;
-    ring->sw_head = (uint16_t)((ring->sw_head + 1u) % ring->sw_size);
-    ring->pushed_bytes++;
+    // Default buffers can back only one ring; others must bring their own.
+    if (s_default_owner != NULL && s_default_owner != ring)
+    {
+        (void)memset(ring, 0, sizeof(*ring)); // huart == NULL -> StartDma fails
+        return;
+    }
+    s_default_owner = ring;
+
+#if UART_RX_RING_DIRECT_DMA
+    UartRxRing_InitWithBuffers(ring, huart,
+                               s_default_dma_buf, (uint16_t)UART_RX_RING_DMA_BUF_SIZE,
+                               NULL, 0u);
+#else
+    UartRxRing_InitWithBuffers(ring, huart,
+                               s_default_dma_buf, (uint16_t)UART_RX_RING_DMA_BUF_SIZE,
+                               s_default_sw_buf, (uint16_t)UART_RX_RING_SW_BUF_SIZE);
+#endif
 }
 
-void UartRxRing_Init(UartRxRing* ring, UART_HandleTypeDef* huart)
+void UartRxRing_InitWithBuffers(UartRxRing* ring, UART_HandleTypeDef* huart,
+                                uint8_t* dma_buf, uint16_t dma_size,
+                                uint8_t* sw_buf, uint16_t sw_size)
 {
     if (ring == NULL)
     {
         return;
     }
 
+    (void)memset(ring, 0, sizeof(*ring));
+
+    // Invalid storage leaves huart == NULL, so StartDma() reports HAL_ERROR.
+    if (dma_buf == NULL || dma_size < 2u)
+    {
+        return;
+    }
+
+#if UART_RX_RING_DIRECT_DMA
+    (void)sw_buf;
+    (void)sw_size;
+#else
+    if (sw_buf == NULL || sw_size < 2u || (sw_size & (sw_size - 1u)) != 0u)
+    {
+        return;
+    }
+#endif
+
     ring->huart = huart;
 
-    ring->dma_size = (uint16_t)UART_RX_RING_DMA_BUF_SIZE;
+    ring->dma_buf = dma_buf;
+    ring->dma_size = dma_size;
     ring->dma_last_pos = 0u;
 
-    ring->sw_size = (uint16_t)UART_RX_RING_SW_BUF_SIZE;
+#if UART_RX_RING_DIRECT_DMA
+    ring->dma_read_pos = 0u;
+#else
+    ring->sw_buf = sw_buf;
+    ring->sw_size = sw_size;
     ring->sw_head = 0u;
     ring->sw_tail = 0u;
-
-    ring->pushed_bytes = 0u;
-    ring->dropped_bytes = 0u;
-    ring->overflow_events = 0u;
+#endif
 
     // Clear DMA buffer for debug readability (not required)
     (void)memset(ring->dma_buf, 0, ring->dma_size);
 }
 
+// Rings fed from HAL RX callbacks, looked up by UART handle.
+static UartRxRing* s_event_rings[UART_RX_RING_MAX_EVENT_RINGS];
+
+static uint8_t UartRxRing_RegisterEventRing(UartRxRing* ring)
+{
+    for (uint8_t i = 0u; i < UART_RX_RING_MAX_EVENT_RINGS; i++)
+    {
+        if (s_event_rings[i] == ring || s_event_rings[i] == NULL)
+        {
+            s_event_rings[i] = ring;
+            return 1u;
+        }
+    }
+
+    return 0u;
+}
+
+static UartRxRing* UartRxRing_FindEventRing(const UART_HandleTypeDef* huart)
+{
+    for (uint8_t i = 0u; i < UART_RX_RING_MAX_EVENT_RINGS; i++)
+    {
+        if (s_event_rings[i] != NULL && s_event_rings[i]->huart == huart)
+        {
+            return s_event_rings[i];
+        }
+    }
+
+    return NULL;
+}
+
+#if UART_RX_RING_PINGPONG_DMA
+// DMA finished one block (M0 or M1); blocks alternate starting with M0.
+// Counted in dma_half_events, consumed in dma_half_seen.
+static void UartRxRing_PingPongBlockDone(DMA_HandleTypeDef* hdma)
+{
+    UartRxRing* ring = UartRxRing_FindEventRing((const UART_HandleTypeDef*)hdma->Parent);
+    if (ring == NULL)
+    {
+        return;
+    }
+
+    ring->dma_half_events++;
+}
+
+static HAL_StatusTypeDef UartRxRing_StartPingPongDma(UartRxRing* ring);
+
+static void UartRxRing_PingPongError(DMA_HandleTypeDef* hdma)
+{
+    UartRxRing* ring = UartRxRing_FindEventRing((const UART_HandleTypeDef*)hdma->Parent);
+    if (ring == NULL || (hdma->ErrorCode & HAL_DMA_ERROR_TE) == 0u)
+    {
+        return; // not ours, or DME/FE: the stream keeps running
+    }
+
+    // Transfer error: hardware disabled the stream. Release the UART and
+    // restart; bytes of the block being filled are lost.
+    ring->rx_restarts++;
+    ATOMIC_CLEAR_BIT(ring->huart->Instance->CR3, USART_CR3_DMAR);
+    ring->huart->RxState = HAL_UART_STATE_READY;
+    (void)UartRxRing_StartPingPongDma(ring);
+}
+
+// Starts with the block the poller expects next (dma_half_events parity),
+// so a restart keeps completed-but-unpolled blocks and block order intact.
+static HAL_StatusTypeDef UartRxRing_StartPingPongDma(UartRxRing* ring)
+{
+    UART_HandleTypeDef* huart = ring->huart;
+    DMA_HandleTypeDef* hdma = huart->hdmarx;
+    uint16_t block = (uint16_t)(ring->dma_size / 2u);
+    uint16_t first = ((ring->dma_half_events & 1u) != 0u) ? block : 0u;
+
+    if (hdma == NULL || (ring->dma_size & 1u) != 0u || huart->RxState != HAL_UART_STATE_READY)
+    {
+        return HAL_ERROR;
+    }
+
+    hdma->XferCpltCallback = UartRxRing_PingPongBlockDone;
+    hdma->XferM1CpltCallback = UartRxRing_PingPongBlockDone;
+    hdma->XferErrorCallback = UartRxRing_PingPongError;
+    hdma->XferHalfCpltCallback = NULL;
+    hdma->XferM1HalfCpltCallback = NULL;
+
+    // M0 = block filled first, M1 = the other half of dma_buf.
+    HAL_StatusTypeDef st = HAL_DMAEx_MultiBufferStart_IT(hdma,
+                                                         (uint32_t)&huart->Instance->DR,
+                                                         (uint32_t)&ring->dma_buf[first],
+                                                         (uint32_t)&ring->dma_buf[block - first],
+                                                         block);
+    if (st != HAL_OK)
+    {
+        return st;
+    }
+
+    // HAL UART has no double-buffer API: claim RX and enable the DMA
+    // request the same way UART_Start_Receive_DMA() does.
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    __HAL_UART_CLEAR_OREFLAG(huart);
+    ATOMIC_SET_BIT(huart->Instance->CR3, USART_CR3_DMAR);
+
+    return HAL_OK;
+}
+#endif
+
+#if UART_RX_RING_IDLE_DMA
+static HAL_StatusTypeDef UartRxRing_StartIdleDma(UartRxRing* ring)
+{
+    // Circular DMA + IDLE line detection: HAL reports HT, TC and IDLE
+    // through HAL_UARTEx_RxEventCallback() with the current write position.
+    // IMPORTANT: DMA must be configured in CubeMX as Circular.
+    return HAL_UARTEx_ReceiveToIdle_DMA(ring->huart, ring->dma_buf, ring->dma_size);
+}
+#endif
+
 HAL_StatusTypeDef UartRxRing_StartDma(UartRxRing* ring)
 {
-    if (ring == NULL || ring->huart == NULL)
+    if (ring == NULL || ring->huart == NULL || ring->dma_buf == NULL)
     {
         return HAL_ERROR;
     }
 
     ring->dma_last_pos = 0u;
+    ring->dma_half_seen = ring->dma_half_events;
+#if UART_RX_RING_PINGPONG_DMA
+    // Block parity follows dma_half_events, see UartRxRing_StartPingPongDma()
+    if ((ring->dma_half_seen & 1u) != 0u)
+    {
+        ring->dma_last_pos = (uint16_t)(ring->dma_size / 2u);
+    }
+#endif
+#if UART_RX_RING_DIRECT_DMA
+    ring->dma_read_pos = ring->dma_last_pos;
+#endif
+
+    if (UartRxRing_RegisterEventRing(ring) == 0u)
+    {
+        return HAL_ERROR;
+    }
 
+#if UART_RX_RING_IDLE_DMA
+    return UartRxRing_StartIdleDma(ring);
+#elif UART_RX_RING_PINGPONG_DMA
+    return UartRxRing_StartPingPongDma(ring);
+#else
     // Receive continuously into DMA circular buffer.
     // IMPORTANT: DMA must be configured in CubeMX as Circular.
     return HAL_UART_Receive_DMA(ring->huart, ring->dma_buf, ring->dma_size);
+#endif
 }
 
+#if !UART_RX_RING_PINGPONG_DMA
 static uint16_t UartRxRing_GetDmaWritePos(const UartRxRing* ring)
 {
     // For circular DMA reception, NDTR decrements from dma_size to 0 and reloads.
@@ -108,19 +453,93 @@ static uint16_t UartRxRing_GetDmaWritePos(const UartRxRing* ring)
     return pos;
 }
 
-void UartRxRing_PollFromDma(UartRxRing* ring)
+// Number of DMA half/full boundaries (HT/TC events) the write position
+// passes when moving forward by `moved` bytes from `last` (moved < dma_size).
+static uint32_t UartRxRing_HalfBoundariesCrossed(const UartRxRing* ring, uint16_t last, uint16_t moved)
 {
-    if (ring == NULL || ring->huart == NULL)
+    uint32_t half = (uint32_t)ring->dma_size / 2u;
+    uint32_t end = (uint32_t)last + moved;
+    uint32_t crossed = 0u;
+
+    // Boundaries in unwrapped coordinates: half, size, half + size.
+    if (last < half && end >= half)
     {
-        return;
+        crossed++;
     }
+    if (end >= ring->dma_size)
+    {
+        crossed++;
+    }
+    if (end >= (half + ring->dma_size))
+    {
+        crossed++;
+    }
+
+    return crossed;
+}
+
+// DMA cannot tell us it overwrote unread data: after a full lap `pos` looks
+// like a small forward move. HT/TC interrupts count every half-buffer
+// boundary, so boundaries seen beyond what [last..pos) explains are laps.
+// Returns the number of laps found.
+static uint32_t UartRxRing_DetectLap(UartRxRing* ring, uint16_t last, uint16_t moved)
+{
+    uint32_t expected = UartRxRing_HalfBoundariesCrossed(ring, last, moved);
+    int32_t extra = (int32_t)(ring->dma_half_events - ring->dma_half_seen) - (int32_t)expected;
+
+    // extra < 0 or == 1: HT/TC IRQ for an already visible boundary not
+    // served yet; it is accounted for on the next move.
+    uint32_t laps = (extra > 1) ? ((uint32_t)extra / 2u) : 0u;
+
+    if (laps != 0u)
+    {
+        ring->lap_events++;
+        ring->lapped_bytes += laps * ring->dma_size;
+    }
+
+    ring->dma_half_seen += expected + (2u * laps);
 
-    uint16_t pos = UartRxRing_GetDmaWritePos(ring);
+    return laps;
+}
+#endif
+
+#if UART_RX_RING_DIRECT_DMA && !UART_RX_RING_PINGPONG_DMA
+// After a lap every unread byte in dma_buf was overwritten, although the
+// range still looks valid by index. Discard it like a full ring would:
+// the consumer restarts at the current DMA write position.
+static void UartRxRing_DropLapped(UartRxRing* ring, uint16_t pos, uint16_t moved)
+{
+    // Visible-but-unread bytes plus the new ones; whole laps are already in
+    // lapped_bytes.
+    uint32_t unread = (uint32_t)UartRxRing_DmaAvail(ring) + moved;
+
+    ring->dma_read_pos = pos;
+    ring->dma_last_pos = pos;
+    ring->overflow_events++;
+    ring->dropped_bytes += unread;
+}
+#endif
+
+// Moves DMA bytes [dma_last_pos..pos) into SW ring
+// (direct mode: makes them visible to the consumer in place).
+// Returns number of new DMA bytes seen.
+static uint16_t UartRxRing_MoveFromDma(UartRxRing* ring, uint16_t pos)
+{
     uint16_t last = ring->dma_last_pos;
 
     if (pos == last)
     {
-        return; // no new data
+#if UART_RX_RING_DIRECT_DMA && !UART_RX_RING_PINGPONG_DMA
+        // Could still be whole laps: check before "no new data".
+        if (UartRxRing_DetectLap(ring, last, 0u) != 0u)
+        {
+            UartRxRing_DropLapped(ring, pos, 0u);
+        }
+#elif !UART_RX_RING_PINGPONG_DMA
+        // Could still be whole laps: check before "no new data".
+        (void)UartRxRing_DetectLap(ring, last, 0u);
+#endif
+        return 0u; // no new data
     }
 
     // Calculate how many bytes are new in DMA since last poll (for diagnostics).
@@ -134,31 +553,97 @@ void UartRxRing_PollFromDma(UartRxRing* ring)
         moved = (uint16_t)((ring->dma_size - last) + pos);
     }
 
-    // Move bytes from DMA buffer [last..pos) into SW ring.
-    uint32_t primask = UartRxRing_EnterCritical();
+#if UART_RX_RING_DIRECT_DMA && !UART_RX_RING_PINGPONG_DMA
+    if (UartRxRing_DetectLap(ring, last, moved) != 0u)
+    {
+        UartRxRing_DropLapped(ring, pos, moved);
+        return moved;
+    }
+#elif !UART_RX_RING_PINGPONG_DMA
+    (void)UartRxRing_DetectLap(ring, last, moved);
+#endif
 
-    if (pos > last)
+#if UART_RX_RING_DIRECT_DMA
+    // Nothing to copy. If the consumer has not released enough space, DMA
+    // already overwrote its oldest unread bytes: account them like a full
+    // SW ring and skip the read position past them.
+    uint16_t avail = UartRxRing_DmaAvail(ring);
+    uint16_t free_space = (uint16_t)(ring->dma_size - 1u - avail);
+
+    if (moved > free_space)
     {
-        for (uint16_t i = last; i < pos; i++)
-        {
-            UartRxRing_SwPushByte_NoLock(ring, ring->dma_buf[i]);
-        }
+        uint16_t dropped = (uint16_t)(moved - free_space);
+        uint16_t read = (uint16_t)(ring->dma_read_pos + dropped);
+        ring->dma_read_pos = (read >= ring->dma_size) ? (uint16_t)(read - ring->dma_size) : read;
+        ring->overflow_events++;
+        ring->dropped_bytes += dropped;
+        ring->pushed_bytes += free_space;
     }
     else
     {
-        for (uint16_t i = last; i < ring->dma_size; i++)
-        {
-            UartRxRing_SwPushByte_NoLock(ring, ring->dma_buf[i]);
-        }
-        for (uint16_t i = 0u; i < pos; i++)
+        ring->pushed_bytes += moved;
+    }
+
+    ring->dma_last_pos = pos;
+#else
+    // Move bytes from DMA buffer [last..pos) into SW ring as one block:
+    // DMA side wraps at most once, SW side wraps at most once -> <= 4 memcpy.
+    uint32_t primask = UartRxRing_EnterCritical();
+
+    uint16_t free_space = UartRxRing_SwFreeSpace_NoLock(ring);
+    uint16_t src_off = 0u;
+    uint16_t to_copy = 0u;
+    uint32_t drop_bytes = 0u;
+    uint32_t drop_frames = 0u;
+
+#if UART_RX_RING_DROP_POLICY == UART_RX_RING_DROP_NEWEST_FRAME
+    to_copy = UartRxRing_SelectNewestFrame(ring, last, moved, free_space, &src_off, &drop_frames);
+#elif UART_RX_RING_DROP_POLICY == UART_RX_RING_DROP_OLDEST_FRAME
+    free_space = UartRxRing_MakeRoomOldestFrame(ring, moved, free_space, &drop_bytes, &drop_frames);
+    if (moved > free_space)
+    {
+        // Block larger than the whole ring: keep its newest frames only.
+        src_off = (uint16_t)(moved - free_space);
+        while (src_off < moved && UartRxRing_IsStx(UartRxRing_DmaByteAt(ring, last, src_off)) == 0u)
         {
-            UartRxRing_SwPushByte_NoLock(ring, ring->dma_buf[i]);
+            src_off++;
         }
+        drop_frames += UartRxRing_CountStx(ring, last, 0u, src_off);
+    }
+    to_copy = (uint16_t)(moved - src_off);
+#else
+    // Newest bytes are dropped, same as the old per-byte path.
+    to_copy = (moved < free_space) ? moved : free_space;
+#endif
+    drop_bytes += (uint32_t)(moved - to_copy);
+
+    uint16_t start = (uint16_t)(last + src_off);
+    if (start >= ring->dma_size)
+    {
+        start = (uint16_t)(start - ring->dma_size);
+    }
+
+    uint16_t dma_to_end = (uint16_t)(ring->dma_size - start);
+    uint16_t seg1 = (to_copy < dma_to_end) ? to_copy : dma_to_end;
+
+    UartRxRing_SwWrite_NoLock(ring, &ring->dma_buf[start], seg1);
+    if (to_copy > seg1)
+    {
+        UartRxRing_SwWrite_NoLock(ring, &ring->dma_buf[0], (uint16_t)(to_copy - seg1));
+    }
+
+    ring->pushed_bytes += to_copy;
+    if (drop_bytes != 0u)
+    {
+        ring->overflow_events++;
+        ring->dropped_bytes += drop_bytes;
+        ring->dropped_frames += drop_frames;
     }
 
     ring->dma_last_pos = pos;
 
     UartRxRing_ExitCritical(primask);
+#endif
 
     // ---- DIAGNOSTICS (log once per second) ----
     // NOTE: Keep this lightweight. If needed, you can guard by a compile-time flag.
@@ -181,9 +666,191 @@ void UartRxRing_PollFromDma(UartRxRing* ring)
 //            (unsigned long)ring->dropped_bytes,
 //            (unsigned long)ring->overflow_events);
 //    }
+
+    return moved;
+}
+
+#if UART_RX_RING_PINGPONG_DMA
+// Hands every block completed since the last poll to the consumer as one
+// unit. The block being filled is never touched. If DMA completed two or
+// more blocks, all but the newest were overwritten already (lap).
+// Returns bytes delivered.
+static uint16_t UartRxRing_MoveCompletedBlocks(UartRxRing* ring)
+{
+    uint16_t block = (uint16_t)(ring->dma_size / 2u);
+    uint16_t total = 0u;
+
+    while (ring->dma_half_events != ring->dma_half_seen)
+    {
+        uint32_t pending = ring->dma_half_events - ring->dma_half_seen;
+
+        if (pending >= 2u)
+        {
+            uint32_t lost = pending - 1u;
+            ring->lap_events++;
+            ring->lapped_bytes += lost * block;
+            ring->dma_half_seen += lost;
+
+            // Skip to the start of the newest completed block.
+            ring->dma_last_pos = ((ring->dma_half_seen & 1u) != 0u) ? block : 0u;
+#if UART_RX_RING_DIRECT_DMA
+            ring->dma_read_pos = ring->dma_last_pos;
+#endif
+        }
+
+        uint16_t end = ((ring->dma_half_seen & 1u) != 0u) ? 0u : block;
+        total = (uint16_t)(total + UartRxRing_MoveFromDma(ring, end));
+        ring->dma_half_seen++;
+    }
+
+    return total;
 }
+#endif
 
+#if UART_RX_RING_HISTOGRAMS
+// Bucket 0 holds 0, bucket k (k >= 1) holds [2^(k-1) .. 2^k - 1].
+static uint8_t UartRxRing_Log2Bucket(uint16_t v)
+{
+    return (v == 0u) ? 0u : (uint8_t)(32u - __CLZ((uint32_t)v));
+}
 
+// Samples SW ring occupancy and the size of this poll's DMA batch.
+static void UartRxRing_RecordPoll(UartRxRing* ring, uint16_t moved)
+{
+#if UART_RX_RING_DIRECT_DMA
+    uint16_t occupancy = UartRxRing_DmaAvail(ring);
+#else
+    uint16_t occupancy = (uint16_t)((ring->sw_head - ring->sw_tail) & UartRxRing_SwMask(ring));
+#endif
+
+    if (occupancy > ring->hist.high_water)
+    {
+        ring->hist.high_water = occupancy;
+    }
+
+    ring->hist.occupancy[UartRxRing_Log2Bucket(occupancy)]++;
+    ring->hist.poll_bytes[UartRxRing_Log2Bucket(moved)]++;
+    ring->hist.samples++;
+}
+#endif
+
+void UartRxRing_PollFromDma(UartRxRing* ring)
+{
+    if (ring == NULL || ring->huart == NULL)
+    {
+        return;
+    }
+
+    // Track worst-case poll interval for DMA buffer sizing.
+    uint32_t now = HAL_GetTick();
+    if (ring->last_poll_ms != 0u)
+    {
+        uint32_t gap = now - ring->last_poll_ms;
+        if (gap > ring->max_poll_gap_ms)
+        {
+            ring->max_poll_gap_ms = gap;
+        }
+    }
+    ring->last_poll_ms = now;
+
+#if UART_RX_RING_PINGPONG_DMA
+    uint16_t moved = UartRxRing_MoveCompletedBlocks(ring);
+#else
+    uint16_t moved = UartRxRing_MoveFromDma(ring, UartRxRing_GetDmaWritePos(ring));
+#endif
+
+#if UART_RX_RING_HISTOGRAMS
+    UartRxRing_RecordPoll(ring, moved);
+#else
+    (void)moved;
+#endif
+}
+
+void UartRxRing_OnDmaBoundary(UART_HandleTypeDef* huart)
+{
+    UartRxRing* ring = UartRxRing_FindEventRing(huart);
+    if (ring == NULL)
+    {
+        return;
+    }
+
+    ring->dma_half_events++;
+}
+
+uint32_t UartRxRing_GetRecommendedDmaSize(const UartRxRing* ring)
+{
+    if (ring == NULL || ring->huart == NULL || ring->max_poll_gap_ms == 0u)
+    {
+        return 0u;
+    }
+
+    // 8N1: 10 bit times per byte. Keep 2x margin over the worst poll gap,
+    // rounded up to a power of two.
+    uint32_t bytes_per_s = ring->huart->Init.BaudRate / 10u;
+    uint32_t needed = (uint32_t)(((uint64_t)bytes_per_s * ring->max_poll_gap_ms * 2u) / 1000u);
+
+    uint32_t size = 64u;
+    while (size < needed && size < 0x8000u)
+    {
+        size <<= 1u;
+    }
+
+    return size;
+}
+
+#if UART_RX_RING_IDLE_DMA
+void UartRxRing_OnRxEvent(UART_HandleTypeDef* huart, uint16_t size)
+{
+    UartRxRing* ring = UartRxRing_FindEventRing(huart);
+    if (ring == NULL)
+    {
+        return;
+    }
+
+    HAL_UART_RxEventTypeTypeDef type = HAL_UARTEx_GetRxEventType(huart);
+    if (type == HAL_UART_RXEVENT_HT || type == HAL_UART_RXEVENT_TC)
+    {
+        ring->dma_half_events++;
+    }
+
+    // size is the DMA write position; at TC it equals dma_size (wrap to 0).
+    uint16_t pos = (size >= ring->dma_size) ? 0u : size;
+    uint16_t moved = UartRxRing_MoveFromDma(ring, pos);
+
+#if UART_RX_RING_HISTOGRAMS
+    UartRxRing_RecordPoll(ring, moved);
+#else
+    (void)moved;
+#endif
+}
+
+#endif
+
+#if UART_RX_RING_IDLE_DMA || UART_RX_RING_PINGPONG_DMA
+void UartRxRing_OnError(UART_HandleTypeDef* huart)
+{
+    UartRxRing* ring = UartRxRing_FindEventRing(huart);
+    if (ring == NULL || huart->RxState != HAL_UART_STATE_READY)
+    {
+        return; // not ours, or non-blocking error (reception still running)
+    }
+
+    // HAL aborts DMA reception on blocking errors (e.g. ORE).
+    ring->rx_restarts++;
+#if UART_RX_RING_IDLE_DMA
+    // Bytes received since the last event are lost; restart from the
+    // beginning of dma_buf.
+    ring->dma_last_pos = 0u;
+    (void)UartRxRing_StartIdleDma(ring);
+#else
+    // The block being filled is lost; completed blocks are still polled.
+    (void)UartRxRing_StartPingPongDma(ring);
+#endif
+}
+#endif
+
+
+#if UART_RX_RING_DIRECT_DMA
 uint16_t UartRxRing_Available(const UartRxRing* ring)
 {
     if (ring == NULL)
@@ -191,21 +858,106 @@ uint16_t UartRxRing_Available(const UartRxRing* ring)
         return 0u;
     }
 
-    uint32_t primask = UartRxRing_EnterCritical();
+    return UartRxRing_DmaAvail(ring);
+}
 
-    uint16_t head = ring->sw_head;
-    uint16_t tail = ring->sw_tail;
-    uint16_t avail = 0u;
+uint16_t UartRxRing_Peek(UartRxRing* ring, UartRxRing_Span* first, UartRxRing_Span* second)
+{
+    if (first != NULL)
+    {
+        first->data = NULL;
+        first->len = 0u;
+    }
+    if (second != NULL)
+    {
+        second->data = NULL;
+        second->len = 0u;
+    }
 
-    if (head >= tail)
+    if (ring == NULL || first == NULL || second == NULL)
     {
-        avail = (uint16_t)(head - tail);
+        return 0u;
+    }
+
+    uint16_t last = ring->dma_last_pos;
+    uint16_t read = ring->dma_read_pos;
+
+    // Spans point into dma_buf: they stay valid only until DMA laps them,
+    // so consume them before the next PollFromDma().
+    if (last >= read)
+    {
+        first->data = &ring->dma_buf[read];
+        first->len = (uint16_t)(last - read);
     }
     else
     {
-        avail = (uint16_t)(ring->sw_size - tail + head);
+        first->data = &ring->dma_buf[read];
+        first->len = (uint16_t)(ring->dma_size - read);
+        if (last > 0u)
+        {
+            second->data = &ring->dma_buf[0];
+            second->len = last;
+        }
     }
 
+    return (uint16_t)(first->len + second->len);
+}
+
+void UartRxRing_Commit(UartRxRing* ring, uint16_t n)
+{
+    if (ring == NULL || n == 0u)
+    {
+        return;
+    }
+
+    uint16_t avail = UartRxRing_DmaAvail(ring);
+    if (n > avail)
+    {
+        n = avail;
+    }
+
+    uint16_t read = (uint16_t)(ring->dma_read_pos + n);
+    ring->dma_read_pos = (read >= ring->dma_size) ? (uint16_t)(read - ring->dma_size) : read;
+}
+
+uint16_t UartRxRing_Read(UartRxRing* ring, uint8_t* out, uint16_t max_len)
+{
+    if (ring == NULL || out == NULL || max_len == 0u)
+    {
+        return 0u;
+    }
+
+    UartRxRing_Span spans[2];
+    (void)UartRxRing_Peek(ring, &spans[0], &spans[1]);
+
+    uint16_t first = (spans[0].len < max_len) ? spans[0].len : max_len;
+    uint16_t rest = (uint16_t)(max_len - first);
+    uint16_t second = (spans[1].len < rest) ? spans[1].len : rest;
+
+    (void)memcpy(out, spans[0].data, first);
+    if (second != 0u)
+    {
+        (void)memcpy(&out[first], spans[1].data, second);
+    }
+
+    UartRxRing_Commit(ring, (uint16_t)(first + second));
+
+    return (uint16_t)(first + second);
+}
+
+#else
+uint16_t UartRxRing_Available(const UartRxRing* ring)
+{
+    if (ring == NULL)
+    {
+        return 0u;
+    }
+
+    uint32_t primask = UartRxRing_EnterCritical();
+
+    uint16_t head = UartRxRing_LoadAcquire(&ring->sw_head);
+    uint16_t avail = (uint16_t)((head - ring->sw_tail) & UartRxRing_SwMask(ring));
+
     UartRxRing_ExitCritical(primask);
 
     return avail;
@@ -218,27 +970,98 @@ uint16_t UartRxRing_Read(UartRxRing* ring, uint8_t* out, uint16_t max_len)
         return 0u;
     }
 
-    uint16_t read_count = 0u;
+    uint32_t primask = UartRxRing_EnterCritical();
+
+    uint16_t head = UartRxRing_LoadAcquire(&ring->sw_head);
+    uint16_t tail = ring->sw_tail;
+    uint16_t avail = (uint16_t)((head - tail) & UartRxRing_SwMask(ring));
+    uint16_t read_count = (avail < max_len) ? avail : max_len;
+
+    uint16_t to_end = (uint16_t)(ring->sw_size - tail);
+    uint16_t first = (read_count < to_end) ? read_count : to_end;
+
+    (void)memcpy(out, &ring->sw_buf[tail], first);
+    if (read_count > first)
+    {
+        (void)memcpy(&out[first], &ring->sw_buf[0], (size_t)(read_count - first));
+    }
+
+    UartRxRing_StoreRelease(&ring->sw_tail, (uint16_t)((tail + read_count) & UartRxRing_SwMask(ring)));
+
+    UartRxRing_ExitCritical(primask);
+
+    return read_count;
+}
+
+uint16_t UartRxRing_Peek(UartRxRing* ring, UartRxRing_Span* first, UartRxRing_Span* second)
+{
+    if (first != NULL)
+    {
+        first->data = NULL;
+        first->len = 0u;
+    }
+    if (second != NULL)
+    {
+        second->data = NULL;
+        second->len = 0u;
+    }
+
+    if (ring == NULL || first == NULL || second == NULL)
+    {
+        return 0u;
+    }
 
     uint32_t primask = UartRxRing_EnterCritical();
+    uint16_t head = UartRxRing_LoadAcquire(&ring->sw_head);
+    uint16_t tail = ring->sw_tail;
+    UartRxRing_ExitCritical(primask);
 
-    while (read_count < max_len)
+    // Producer only writes into free space, so [tail..head) stays stable
+    // until the consumer commits it. No lock needed while parsing.
+    if (head >= tail)
+    {
+        first->data = &ring->sw_buf[tail];
+        first->len = (uint16_t)(head - tail);
+    }
+    else
     {
-        if (ring->sw_tail == ring->sw_head)
+        first->data = &ring->sw_buf[tail];
+        first->len = (uint16_t)(ring->sw_size - tail);
+        if (head > 0u)
         {
-            break; // empty
+            second->data = &ring->sw_buf[0];
+            second->len = head;
         }
+    }
 
-        out[read_count] = ring->sw_buf[ring->sw_tail];
-        ring->sw_tail = (uint16_t)((ring->sw_tail + 1u) % ring->sw_size);
-        read_count++;
+    return (uint16_t)(first->len + second->len);
+}
+
+void UartRxRing_Commit(UartRxRing* ring, uint16_t n)
+{
+    if (ring == NULL || n == 0u)
+    {
+        return;
     }
 
-    UartRxRing_ExitCritical(primask);
+    uint32_t primask = UartRxRing_EnterCritical();
 
-    return read_count;
+    uint16_t head = UartRxRing_LoadAcquire(&ring->sw_head);
+    uint16_t tail = ring->sw_tail;
+    uint16_t avail = (uint16_t)((head - tail) & UartRxRing_SwMask(ring));
+
+    if (n > avail)
+    {
+        n = avail;
+    }
+
+    UartRxRing_StoreRelease(&ring->sw_tail, (uint16_t)((tail + n) & UartRxRing_SwMask(ring)));
+
+    UartRxRing_ExitCritical(primask);
 }
 
+#endif
+
 void UartRxRing_GetStats(const UartRxRing* ring, UartRxRing_Stats* out_stats)
 {
     if (ring == NULL || out_stats == NULL)
@@ -251,6 +1074,40 @@ void UartRxRing_GetStats(const UartRxRing* ring, UartRxRing_Stats* out_stats)
     out_stats->pushed_bytes = ring->pushed_bytes;
     out_stats->dropped_bytes = ring->dropped_bytes;
     out_stats->overflow_events = ring->overflow_events;
+    out_stats->dropped_frames = ring->dropped_frames;
+    out_stats->lapped_bytes = ring->lapped_bytes;
+    out_stats->lap_events = ring->lap_events;
+    out_stats->max_poll_gap_ms = ring->max_poll_gap_ms;
+    out_stats->rx_restarts = ring->rx_restarts;
 
     UartRxRing_ExitCritical(primask);
 }
+
+#if UART_RX_RING_HISTOGRAMS
+void UartRxRing_GetHistograms(const UartRxRing* ring, UartRxRing_Histograms* out_hist)
+{
+    if (ring == NULL || out_hist == NULL)
+    {
+        return;
+    }
+
+    // Producer may run in ISR: take a consistent copy.
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *out_hist = ring->hist;
+    __set_PRIMASK(primask);
+}
+
+void UartRxRing_ResetHistograms(UartRxRing* ring)
+{
+    if (ring == NULL)
+    {
+        return;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    (void)memset(&ring->hist, 0, sizeof(ring->hist));
+    __set_PRIMASK(primask);
+}
+#endif
@@ -31,6 +31,19 @@
 #define HEALTH_BATT_CRIT_V 10.5f
 #endif
 
+#ifndef HEALTH_LOSS_WARN_PERMILLE
+#define HEALTH_LOSS_WARN_PERMILLE 50u
+#endif
+
+#ifndef HEALTH_LOSS_CRIT_PERMILLE
+#define HEALTH_LOSS_CRIT_PERMILLE 250u
+#endif
+
+// Expected frames needed before a source's loss estimate is trusted
+#ifndef HEALTH_LOSS_MIN_FRAMES
+#define HEALTH_LOSS_MIN_FRAMES 50u
+#endif
+
 static uint32_t s_last_log_ms = 0u;
 
 static HealthLevel HealthRules_Evaluate(const TelemetryState* t, uint32_t now_ms)
@@ -85,6 +98,23 @@ static HealthLevel HealthRules_Evaluate(const TelemetryState* t, uint32_t now_ms
         }
     }
 
+    // Packet loss rule (once the estimate has enough frames)
+    if (LinkQuality_WindowFrames(&t->link) >= HEALTH_LOSS_MIN_FRAMES)
+    {
+        uint16_t loss = LinkQuality_LossPermille(&t->link);
+        if (loss >= HEALTH_LOSS_CRIT_PERMILLE)
+        {
+            level = HEALTH_CRIT;
+        }
+        else if (loss >= HEALTH_LOSS_WARN_PERMILLE)
+        {
+            if (level < HEALTH_WARN)
+            {
+                level = HEALTH_WARN;
+            }
+        }
+    }
+
     // GPS rule (only if available)
     if (t->has_gps)
     {
@@ -117,11 +147,10 @@ void HealthRules_Init(void)
     s_last_log_ms = 0u;
 }
 
+// One line per source: each sender is judged on its own heartbeat, battery,
+// GPS and sequence loss.
 void HealthRules_Update(uint32_t now_ms)
 {
-    const TelemetryState* t = Telemetry_Get();
-    HealthLevel lvl = HealthRules_Evaluate(t, now_ms);
-
     // Log summary once per second (MVP)
     if ((now_ms - s_last_log_ms) < HEALTH_RULES_LOG_PERIOD_MS)
     {
@@ -129,20 +158,35 @@ void HealthRules_Update(uint32_t now_ms)
     }
     s_last_log_ms = now_ms;
 
-    uint32_t dt_hb = (t->last_hb_ms == 0u) ? 0xFFFFFFFFu : (now_ms - t->last_hb_ms);
-    uint32_t dt_link = (t->last_msg_ms == 0u) ? 0xFFFFFFFFu : (now_ms - t->last_msg_ms);
-
+    uint32_t count = Telemetry_GetSourceCount();
+    if (count == 0u)
+    {
+        Logger_Write(LOG_LEVEL_INFO, "HEALTH", "lvl=%s sources=0",
+                     HealthRules_LevelToStr(HealthRules_Evaluate(NULL, now_ms)));
+        return;
+    }
 
-    Logger_Write(LOG_LEVEL_INFO, "HEALTH",
-    	"lvl=%s sys=%u comp=%u armed=%u link_dt=%lu hb_dt=%lu hb_count=%lu batt=%.2fV gps_fix=%u sats=%u",
-        HealthRules_LevelToStr(lvl),
-        (unsigned)t->sysid,
-        (unsigned)t->compid,
-        (unsigned)(t->armed ? 1u : 0u),
-		(unsigned long)dt_link,
-        (unsigned long)dt_hb,
-        (unsigned long)t->hb_count,
-        (double)(t->has_battery ? t->battery_voltage_v : 0.0f),
-        (unsigned)(t->has_gps ? t->gps_fix_type : 0u),
-        (unsigned)(t->has_gps ? t->gps_sats_visible : 0u));
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        const TelemetryState* t = Telemetry_GetSource(i);
+        HealthLevel lvl = HealthRules_Evaluate(t, now_ms);
+
+        uint32_t dt_hb = (t->last_hb_ms == 0u) ? 0xFFFFFFFFu : (now_ms - t->last_hb_ms);
+        uint32_t dt_link = (t->last_msg_ms == 0u) ? 0xFFFFFFFFu : (now_ms - t->last_msg_ms);
+        uint16_t loss = LinkQuality_LossPermille(&t->link);
+
+        Logger_Write(LOG_LEVEL_INFO, "HEALTH",
+            "lvl=%s sys=%u comp=%u armed=%u link_dt=%lu hb_dt=%lu hb_count=%lu batt=%.2fV gps_fix=%u sats=%u loss=%u.%u%%",
+            HealthRules_LevelToStr(lvl),
+            (unsigned)t->sysid,
+            (unsigned)t->compid,
+            (unsigned)(t->armed ? 1u : 0u),
+            (unsigned long)dt_link,
+            (unsigned long)dt_hb,
+            (unsigned long)t->hb_count,
+            (double)(t->has_battery ? t->battery_voltage_v : 0.0f),
+            (unsigned)(t->has_gps ? t->gps_fix_type : 0u),
+            (unsigned)(t->has_gps ? t->gps_sats_visible : 0u),
+            (unsigned)(loss / 10u), (unsigned)(loss % 10u));
+    }
 }
@@ -0,0 +1,46 @@
+#include "mavlink_lib.h"
+#include "mavlink_msg_index_gen.h"
+
+// Full dialect, or only the entries kept by the generator's --keep list
+static const mavlink_msg_entry_t s_msg_entries[] = MAVLINK_MSG_INDEX_ENTRIES;
+
+_Static_assert((sizeof(s_msg_entries) / sizeof(s_msg_entries[0])) == MAVLINK_MSG_INDEX_COUNT,
+               "MAVLink msg index out of date: rerun scripts/gen_mavlink_msg_index.py");
+_Static_assert((sizeof((const mavlink_msg_entry_t[])MAVLINK_MESSAGE_CRCS) / sizeof(mavlink_msg_entry_t)) ==
+               MAVLINK_MSG_INDEX_DIALECT_COUNT,
+               "MAVLink dialect changed: rerun scripts/gen_mavlink_msg_index.py");
+
+const mavlink_msg_entry_t* mavlink_get_msg_entry(uint32_t msgid)
+{
+    uint8_t idx;
+
+#if (MAVLINK_MSG_INDEX_LOW_SIZE > 0u)
+    if (msgid < MAVLINK_MSG_INDEX_LOW_SIZE)
+    {
+        idx = s_msg_index_low[msgid];
+    }
+    else
+#endif
+    {
+        idx = s_msg_index_high[(uint32_t)(msgid * MAVLINK_MSG_INDEX_HASH_MULT) >> (32u - MAVLINK_MSG_INDEX_HASH_BITS)];
+    }
+
+    if (idx == 0u)
+    {
+        return NULL;
+    }
+
+    // A hash slot can be hit by an unknown msgid: confirm the match
+    const mavlink_msg_entry_t* e = &s_msg_entries[idx - 1u];
+    return (e->msgid == msgid) ? e : NULL;
+}
+
+uint32_t MavlinkMsgEntry_Count(void)
+{
+    return MAVLINK_MSG_INDEX_COUNT;
+}
+
+uint8_t MavlinkMsgEntry_IsTrimmed(void)
+{
+    return (uint8_t)MAVLINK_MSG_INDEX_TRIMMED;
+}
@@ -0,0 +1,57 @@
+// Generated by scripts/gen_mavlink_msg_index.py from Core/Inc/mavlink/common/common.h.
+// Do not edit; rerun the script after changing the dialect.
+#pragma once
+
+#include <stdint.h>
+
+#define MAVLINK_MSG_INDEX_TRIMMED       0
+#define MAVLINK_MSG_INDEX_DIALECT_COUNT 232u
+#define MAVLINK_MSG_INDEX_COUNT         232u
+#define MAVLINK_MSG_INDEX_LOW_SIZE      512u
+#define MAVLINK_MSG_INDEX_HASH_MULT     0xE8FE8DFFu
+#define MAVLINK_MSG_INDEX_HASH_BITS     4u
+
+#define MAVLINK_MSG_INDEX_ENTRIES MAVLINK_MESSAGE_CRCS
+
+// msgid -> entry index + 1 (0 = unknown)
+static const uint8_t s_msg_index_low[MAVLINK_MSG_INDEX_LOW_SIZE] =
+{
+      1u,   2u,   3u,   0u,   4u,   5u,   6u,   7u,   8u,   0u,   0u,   9u,   0u,   0u,   0u,   0u,
+      0u,   0u,   0u,   0u,  10u,  11u,  12u,  13u,  14u,  15u,  16u,  17u,  18u,  19u,  20u,  21u,
+     22u,  23u,  24u,  25u,  26u,  27u,  28u,  29u,  30u,  31u,  32u,  33u,  34u,  35u,  36u,  37u,
+     38u,  39u,  40u,  41u,   0u,   0u,  42u,  43u,   0u,   0u,   0u,   0u,   0u,  44u,  45u,  46u,
+     47u,  48u,  49u,  50u,   0u,  51u,  52u,   0u,   0u,  53u,  54u,  55u,  56u,  57u,   0u,   0u,
+     58u,  59u,  60u,  61u,  62u,  63u,  64u,  65u,   0u,  66u,  67u,  68u,  69u,  70u,   0u,   0u,
+      0u,   0u,   0u,   0u,  71u,  72u,  73u,  74u,  75u,  76u,  77u,  78u,  79u,  80u,  81u,  82u,
+     83u,  84u,  85u,  86u,  87u,  88u,  89u,  90u,  91u,  92u,  93u,  94u,  95u,  96u,  97u,  98u,
+     99u, 100u, 101u, 102u, 103u, 104u, 105u, 106u, 107u, 108u, 109u, 110u, 111u, 112u, 113u, 114u,
+    115u,   0u, 116u, 117u, 118u, 119u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,
+      0u,   0u, 120u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,
+      0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,
+    121u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,
+      0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,
+      0u, 122u,   0u,   0u,   0u,   0u, 123u, 124u, 125u, 126u, 127u, 128u,   0u,   0u,   0u,   0u,
+      0u, 129u, 130u, 131u, 132u, 133u, 134u, 135u, 136u, 137u, 138u, 139u, 140u, 141u, 142u,   0u,
+    143u, 144u, 145u, 146u, 147u, 148u, 149u, 150u, 151u, 152u, 153u, 154u, 155u, 156u, 157u, 158u,
+      0u,   0u,   0u, 159u, 160u, 161u,   0u,   0u, 162u, 163u, 164u, 165u, 166u, 167u, 168u, 169u,
+    170u,   0u, 171u, 172u,   0u,   0u,   0u, 173u,   0u,   0u,   0u, 174u, 175u, 176u,   0u,   0u,
+      0u,   0u,   0u,   0u,   0u,   0u, 177u, 178u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,
+    179u, 180u, 181u, 182u, 183u,   0u,   0u,   0u,   0u,   0u, 184u, 185u, 186u, 187u, 188u, 189u,
+    190u,   0u,   0u, 191u, 192u,   0u,   0u,   0u,   0u, 193u,   0u,   0u,   0u,   0u, 194u,   0u,
+      0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u, 195u, 196u,   0u,   0u,   0u,   0u,   0u,   0u,
+      0u,   0u, 197u, 198u, 199u, 200u,   0u, 201u,   0u,   0u,   0u,   0u, 202u,   0u,   0u,   0u,
+      0u, 203u, 204u, 205u, 206u,   0u, 207u,   0u,   0u,   0u,   0u, 208u, 209u, 210u,   0u,   0u,
+    211u, 212u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u, 213u, 214u, 215u, 216u,   0u,   0u,
+      0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,
+      0u,   0u,   0u, 217u, 218u, 219u,   0u,   0u, 220u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,
+      0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,
+      0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,
+      0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,
+      0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u
+};
+
+// ((msgid * MULT) >> (32 - BITS)) -> entry index + 1 (0 = unknown)
+static const uint8_t s_msg_index_high[1u << MAVLINK_MSG_INDEX_HASH_BITS] =
+{
+    231u, 230u,   0u, 221u, 228u, 227u, 229u, 226u, 225u,   0u, 224u, 223u, 222u,   0u, 232u,   0u
+};
@@ -1,34 +1,132 @@
 #include "mavlink_rx.h"
 #include <stddef.h>
-#include "mavlink/common/mavlink.h"
+#include <string.h>
+#include "mavlink_lib.h"
 #include "logger.h"
 
 #define USE_MAVLINK_C_LIB 1
-#ifndef MAVLINK_RX_READ_CHUNK
-#define MAVLINK_RX_READ_CHUNK 64u
-#endif
 
-void MavlinkRx_Init(MavlinkRx* self, UART_HandleTypeDef* huart)
+#ifdef USE_MAVLINK_C_LIB
+// Channel -> owning instance. The library reaches the parse status and
+// frame buffer of a channel through the two hooks below, so an owned
+// channel resolves to that MavlinkRx's own state. Unowned channels keep a
+// private status and share one scratch frame.
+static MavlinkRx* s_channel_owner[MAVLINK_COMM_NUM_BUFFERS];
+static mavlink_status_t s_unowned_status[MAVLINK_COMM_NUM_BUFFERS];
+static mavlink_message_t s_unowned_buffer;
+
+mavlink_status_t* mavlink_get_channel_status(uint8_t chan)
 {
-    if (self == NULL)
+    if (chan >= MAVLINK_COMM_NUM_BUFFERS)
     {
-        return;
+        chan = MAVLINK_COMM_NUM_BUFFERS - 1u;
+    }
+
+    MavlinkRx* owner = s_channel_owner[chan];
+    return (owner != NULL) ? &owner->mav_status : &s_unowned_status[chan];
+}
+
+mavlink_message_t* mavlink_get_channel_buffer(uint8_t chan)
+{
+    if (chan >= MAVLINK_COMM_NUM_BUFFERS)
+    {
+        return &s_unowned_buffer;
     }
 
+    MavlinkRx* owner = s_channel_owner[chan];
+    return (owner != NULL) ? owner->rx_msg : &s_unowned_buffer;
+}
+
+static uint8_t MavlinkRx_ClaimChannel(MavlinkRx* self)
+{
+    // Re-init keeps the channel already owned by this instance.
+    for (uint8_t i = 0u; i < MAVLINK_COMM_NUM_BUFFERS; i++)
+    {
+        if (s_channel_owner[i] == self)
+        {
+            return i;
+        }
+    }
+
+    for (uint8_t i = 0u; i < MAVLINK_COMM_NUM_BUFFERS; i++)
+    {
+        if (s_channel_owner[i] == NULL)
+        {
+            s_channel_owner[i] = self;
+            return i;
+        }
+    }
+
+    return MAVLINK_RX_NO_CHANNEL;
+}
+#endif
+
+static void MavlinkRx_InitCommon(MavlinkRx* self, UART_HandleTypeDef* huart)
+{
     self->huart = huart;
     self->on_message = NULL;
     self->on_message_ctx = NULL;
 
 #ifdef USE_MAVLINK_C_LIB
     // Reset MAVLink parser status
-    self->mav_status.parse_state = 0;
-    self->mav_status.packet_rx_success_count = 0;
-    self->mav_status.packet_rx_drop_count = 0;
+    (void)memset(&self->mav_status, 0, sizeof(self->mav_status));
+    (void)memset(self->slots, 0, sizeof(self->slots));
+    self->slot_busy = 1u;
+    self->rx_msg = &self->slots[0];
+    self->chan = MavlinkRx_ClaimChannel(self);
+    self->sign_link = NULL;
+    if (self->chan == MAVLINK_RX_NO_CHANNEL)
+    {
+        Logger_Write(LOG_LEVEL_WARN, "MAV", "no free MAVLink channel (%u in use)",
+                     (unsigned)MAVLINK_COMM_NUM_BUFFERS);
+    }
+
+    (void)memset(&self->stats, 0, sizeof(self->stats));
+    (void)memset(self->interest, 0xFF, sizeof(self->interest));
+    self->rx_skip = 0u;
+    self->rx_unknown = 0u;
+    self->on_skipped = NULL;
+    self->on_skipped_ctx = NULL;
+
+    (void)memset(self->subs, 0, sizeof(self->subs));
+    (void)memset(self->sub_direct, 0, sizeof(self->sub_direct));
+    (void)memset(self->sub_spill, 0, sizeof(self->sub_spill));
+    self->sub_count = 0u;
+    self->sub_tap = 0u;
+    self->sub_spill_count = 0u;
+
+#if MAVLINK_RX_RESYNC
+    self->resync_enabled = 0u;
+    self->rx_rejected = 0u;
+    self->resync_len = 0u;
+#endif
 #endif
+}
+
+void MavlinkRx_Init(MavlinkRx* self, UART_HandleTypeDef* huart)
+{
+    if (self == NULL)
+    {
+        return;
+    }
 
+    MavlinkRx_InitCommon(self, huart);
     UartRxRing_Init(&self->rx_ring, huart);
 }
 
+void MavlinkRx_InitWithBuffers(MavlinkRx* self, UART_HandleTypeDef* huart,
+                               uint8_t* dma_buf, uint16_t dma_size,
+                               uint8_t* sw_buf, uint16_t sw_size)
+{
+    if (self == NULL)
+    {
+        return;
+    }
+
+    MavlinkRx_InitCommon(self, huart);
+    UartRxRing_InitWithBuffers(&self->rx_ring, huart, dma_buf, dma_size, sw_buf, sw_size);
+}
+
 HAL_StatusTypeDef MavlinkRx_Start(MavlinkRx* self)
 {
     if (self == NULL)
@@ -60,40 +158,1002 @@ void MavlinkRx_GetRxStats(MavlinkRx* self, UartRxRing_Stats* out_stats)
     UartRxRing_GetStats(&self->rx_ring, out_stats);
 }
 
-void MavlinkRx_Update(MavlinkRx* self)
+uint32_t MavlinkRx_GetRecommendedDmaSize(const MavlinkRx* self)
+{
+    if (self == NULL)
+    {
+        return 0u;
+    }
+
+    return UartRxRing_GetRecommendedDmaSize(&self->rx_ring);
+}
+
+#if UART_RX_RING_HISTOGRAMS
+void MavlinkRx_GetRxHistograms(MavlinkRx* self, UartRxRing_Histograms* out_hist, uint8_t reset)
 {
     if (self == NULL)
     {
         return;
     }
 
-    // Move new bytes from DMA circular buffer into SW ring buffer
-    UartRxRing_PollFromDma(&self->rx_ring);
+    UartRxRing_GetHistograms(&self->rx_ring, out_hist);
+    if (reset != 0u)
+    {
+        UartRxRing_ResetHistograms(&self->rx_ring);
+    }
+}
+#endif
+
+#ifdef USE_MAVLINK_C_LIB
+// The span parser mirrors mavlink_frame_char_buffer() + mavlink_parse_char()
+// state for state, including their quirks, so that it stays bit-exact with
+// the reference. Only the per-byte work that does not need the state machine
+// (STX search, payload, signature) is batched.
+
+// Rejected frame; reason is the MavlinkRx_Stats counter to bump.
+static void MavlinkRx_ParseError(MavlinkRx* self, uint32_t* reason)
+{
+    (*reason)++;
+    self->mav_status.parse_error++;
+    self->mav_status.packet_rx_drop_count++;
+#if MAVLINK_RX_RESYNC
+    self->rx_rejected = self->resync_enabled;
+#endif
+}
 
-    // Drain SW ring in small chunks to keep loop responsive
-    uint8_t buf[MAVLINK_RX_READ_CHUNK];
+static void MavlinkRx_StartFrame(MavlinkRx* self, uint8_t stx)
+{
+    self->mav_status.parse_state = MAVLINK_PARSE_STATE_GOT_STX;
+    self->rx_msg->len = 0u;
+    self->rx_msg->magic = stx;
+    self->rx_unknown = 0u;
 
-    while (UartRxRing_Available(&self->rx_ring) > 0u)
+    if (stx == MAVLINK_STX_MAVLINK1)
+    {
+        self->mav_status.flags |= MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+    }
+    else
     {
-        uint16_t n = UartRxRing_Read(&self->rx_ring, buf, (uint16_t)sizeof(buf));
-        if (n == 0u)
+        self->mav_status.flags &= (uint8_t)~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+    }
+
+    mavlink_start_checksum(self->rx_msg);
+}
+
+// Called once the msgid is complete
+static void MavlinkRx_SelectInterest(MavlinkRx* self, uint32_t msgid)
+{
+    self->rx_skip = 0u;
+
+    if ((msgid < MAVLINK_RX_INTEREST_IDS) && (self->mav_status.signing == NULL))
+    {
+        uint32_t bit = (self->interest[msgid >> 5] >> (msgid & 31u)) & 1u;
+        self->rx_skip = (uint8_t)(bit ^ 1u);
+    }
+}
+
+#if !defined(MAVLINK_CHECK_MESSAGE_LENGTH) && (MAVLINK_MAX_PAYLOAD_LEN >= 255)
+// Same result as feeding hdr[1..] through MavlinkRx_ParseByte(), for a
+// header that is complete in memory (hdr[0] is the STX, already taken by
+// MavlinkRx_StartFrame()). Returns false if the header must go the
+// byte-wise way (bad incompat flags), without changing any state.
+static bool MavlinkRx_ParseHeader(MavlinkRx* self, const uint8_t* hdr)
+{
+    mavlink_status_t* st = &self->mav_status;
+    mavlink_message_t* msg = self->rx_msg;
+    uint16_t n;
+
+    if ((st->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) != 0u)
+    {
+        msg->incompat_flags = 0u;
+        msg->compat_flags = 0u;
+        msg->seq = hdr[2];
+        msg->sysid = hdr[3];
+        msg->compid = hdr[4];
+        msg->msgid = hdr[5];
+        n = MAVLINK_CORE_HEADER_MAVLINK1_LEN;
+    }
+    else
+    {
+        if ((hdr[2] & (uint8_t)~MAVLINK_IFLAG_MASK) != 0u)
         {
+            return false;
+        }
+        msg->incompat_flags = hdr[2];
+        msg->compat_flags = hdr[3];
+        msg->seq = hdr[4];
+        msg->sysid = hdr[5];
+        msg->compid = hdr[6];
+        msg->msgid = (uint32_t)hdr[7] | ((uint32_t)hdr[8] << 8) | ((uint32_t)hdr[9] << 16);
+        n = MAVLINK_CORE_HEADER_LEN;
+    }
+    msg->len = hdr[1];
+    st->packet_idx = 0u;
+
+    MavlinkRx_SelectInterest(self, msg->msgid);
+#if MAVLINK_RX_SKIP_CRC
+    if (self->rx_skip == 0u)
+#endif
+    {
+        uint16_t crc = msg->checksum;
+        MavlinkCrc_AccumulateBuffer(&crc, &hdr[1], n);
+        msg->checksum = crc;
+    }
+
+    st->parse_state = (msg->len > 0u) ? MAVLINK_PARSE_STATE_GOT_MSGID3
+                                      : MAVLINK_PARSE_STATE_GOT_PAYLOAD;
+    return true;
+}
+#endif
+
+#if MAVLINK_RX_ACCEPT_UNKNOWN
+// rx_unknown values
+#define MAVLINK_RX_UNKNOWN_CRC      1u  // payload CRC'd: 8-bit check possible
+#define MAVLINK_RX_UNKNOWN_FRAMING  2u  // payload skipped: framing only
+
+// The last CRC step folds CRC_EXTRA in through tmp = extra ^ (crc & 0xFF),
+// tmp ^= tmp << 4, and the high byte of the result is tmp ^ (tmp >> 5).
+// That is invertible, so ck1 fixes the only CRC_EXTRA that could match and
+// ck0 is left as an 8-bit check on the frame.
+static bool MavlinkRx_CrcPlausible(uint16_t crc, uint8_t ck0, uint8_t ck1)
+{
+    uint8_t tmp = (uint8_t)(ck1 ^ (ck1 >> 5));
+    uint8_t lo = (uint8_t)((crc >> 8) ^ (uint8_t)(tmp << 3) ^ (tmp >> 4));
+    return lo == ck0;
+}
+#endif
+
+// Header and CRC bytes, one at a time. Returns MAVLINK_FRAMING_* once the
+// frame is complete (unsigned frames only), otherwise MAVLINK_FRAMING_INCOMPLETE.
+static uint8_t MavlinkRx_ParseByte(MavlinkRx* self, uint8_t c)
+{
+    mavlink_status_t* st = &self->mav_status;
+    mavlink_message_t* msg = self->rx_msg;
+    uint8_t framing = MAVLINK_FRAMING_INCOMPLETE;
+
+    switch (st->parse_state)
+    {
+    case MAVLINK_PARSE_STATE_GOT_STX:
+#if (MAVLINK_MAX_PAYLOAD_LEN < 255)
+        if (c > MAVLINK_MAX_PAYLOAD_LEN)
+        {
+            st->buffer_overrun++;
+            MavlinkRx_ParseError(self, &self->stats.bad_length);
+            st->parse_state = MAVLINK_PARSE_STATE_IDLE;
             break;
         }
+#endif
+        msg->len = c;
+        st->packet_idx = 0u;
+        mavlink_update_checksum(msg, c);
+        if ((st->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) != 0u)
+        {
+            msg->incompat_flags = 0u;
+            msg->compat_flags = 0u;
+            st->parse_state = MAVLINK_PARSE_STATE_GOT_COMPAT_FLAGS;
+        }
+        else
+        {
+            st->parse_state = MAVLINK_PARSE_STATE_GOT_LENGTH;
+        }
+        break;
 
-#ifdef USE_MAVLINK_C_LIB
-        // Feed bytes to MAVLink parser
-        for (uint16_t i = 0u; i < n; i++)
+    case MAVLINK_PARSE_STATE_GOT_LENGTH:
+        msg->incompat_flags = c;
+        if ((c & (uint8_t)~MAVLINK_IFLAG_MASK) != 0u)
         {
-            mavlink_message_t msg;
-            if (mavlink_parse_char(MAVLINK_COMM_0, buf[i], &msg, &self->mav_status) != 0u)
+            // Unknown incompatible feature: drop the frame
+            MavlinkRx_ParseError(self, &self->stats.bad_incompat);
+            st->parse_state = MAVLINK_PARSE_STATE_IDLE;
+            break;
+        }
+        mavlink_update_checksum(msg, c);
+        st->parse_state = MAVLINK_PARSE_STATE_GOT_INCOMPAT_FLAGS;
+        break;
+
+    case MAVLINK_PARSE_STATE_GOT_INCOMPAT_FLAGS:
+        msg->compat_flags = c;
+        mavlink_update_checksum(msg, c);
+        st->parse_state = MAVLINK_PARSE_STATE_GOT_COMPAT_FLAGS;
+        break;
+
+    case MAVLINK_PARSE_STATE_GOT_COMPAT_FLAGS:
+        msg->seq = c;
+        mavlink_update_checksum(msg, c);
+        st->parse_state = MAVLINK_PARSE_STATE_GOT_SEQ;
+        break;
+
+    case MAVLINK_PARSE_STATE_GOT_SEQ:
+        msg->sysid = c;
+        mavlink_update_checksum(msg, c);
+        st->parse_state = MAVLINK_PARSE_STATE_GOT_SYSID;
+        break;
+
+    case MAVLINK_PARSE_STATE_GOT_SYSID:
+        msg->compid = c;
+        mavlink_update_checksum(msg, c);
+        st->parse_state = MAVLINK_PARSE_STATE_GOT_COMPID;
+        break;
+
+    case MAVLINK_PARSE_STATE_GOT_COMPID:
+        msg->msgid = c;
+        mavlink_update_checksum(msg, c);
+        if ((st->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) == 0u)
+        {
+            st->parse_state = MAVLINK_PARSE_STATE_GOT_MSGID1;
+            break;
+        }
+        MavlinkRx_SelectInterest(self, msg->msgid);
+        st->parse_state = (msg->len > 0u) ? MAVLINK_PARSE_STATE_GOT_MSGID3
+                                          : MAVLINK_PARSE_STATE_GOT_PAYLOAD;
+#ifdef MAVLINK_CHECK_MESSAGE_LENGTH
+        if ((msg->len < mavlink_min_message_length(msg)) ||
+            (msg->len > mavlink_max_message_length(msg)))
+        {
+            MavlinkRx_ParseError(self, &self->stats.bad_length);
+            st->parse_state = MAVLINK_PARSE_STATE_IDLE;
+        }
+#endif
+        break;
+
+    case MAVLINK_PARSE_STATE_GOT_MSGID1:
+        msg->msgid |= ((uint32_t)c) << 8;
+        mavlink_update_checksum(msg, c);
+        st->parse_state = MAVLINK_PARSE_STATE_GOT_MSGID2;
+        break;
+
+    case MAVLINK_PARSE_STATE_GOT_MSGID2:
+        msg->msgid |= ((uint32_t)c) << 16;
+        mavlink_update_checksum(msg, c);
+        MavlinkRx_SelectInterest(self, msg->msgid);
+        st->parse_state = (msg->len > 0u) ? MAVLINK_PARSE_STATE_GOT_MSGID3
+                                          : MAVLINK_PARSE_STATE_GOT_PAYLOAD;
+#ifdef MAVLINK_CHECK_MESSAGE_LENGTH
+        if ((msg->len < mavlink_min_message_length(msg)) ||
+            (msg->len > mavlink_max_message_length(msg)))
+        {
+            MavlinkRx_ParseError(self, &self->stats.bad_length);
+            st->parse_state = MAVLINK_PARSE_STATE_IDLE;
+        }
+#endif
+        break;
+
+    case MAVLINK_PARSE_STATE_GOT_PAYLOAD:
+    {
+        const mavlink_msg_entry_t* e = mavlink_get_msg_entry(msg->msgid);
+        msg->ck[0] = c;
+        if (e == NULL)
+        {
+            // Not in the CRC_EXTRA table: cannot be validated
+#if MAVLINK_RX_ACCEPT_UNKNOWN
+            self->rx_unknown = MAVLINK_RX_UNKNOWN_CRC;
+#if MAVLINK_RX_SKIP_CRC
+            if (self->rx_skip != 0u)
             {
-                if (self->on_message != NULL)
+                self->rx_unknown = MAVLINK_RX_UNKNOWN_FRAMING;
+            }
+#endif
+            st->parse_state = MAVLINK_PARSE_STATE_GOT_CRC1;
+#else
+            st->parse_state = MAVLINK_PARSE_STATE_GOT_BAD_CRC1;
+#endif
+            break;
+        }
+
+        mavlink_update_checksum(msg, e->crc_extra);
+        st->parse_state = (c == (uint8_t)(msg->checksum & 0xFFu)) ? MAVLINK_PARSE_STATE_GOT_CRC1
+                                                                  : MAVLINK_PARSE_STATE_GOT_BAD_CRC1;
+#if MAVLINK_RX_SKIP_CRC
+        if (self->rx_skip != 0u)
+        {
+            // Payload was not CRC'd: accept on framing alone
+            st->parse_state = MAVLINK_PARSE_STATE_GOT_CRC1;
+        }
+#endif
+
+        // Zero-fill truncated (v2 trailing-zero) payloads up to full length
+        if ((self->rx_skip == 0u) && (st->packet_idx < e->max_msg_len))
+        {
+            (void)memset(&_MAV_PAYLOAD_NON_CONST(msg)[st->packet_idx], 0,
+                         (size_t)(e->max_msg_len - st->packet_idx));
+        }
+        break;
+    }
+
+    case MAVLINK_PARSE_STATE_GOT_CRC1:
+    case MAVLINK_PARSE_STATE_GOT_BAD_CRC1:
+        if ((st->parse_state == MAVLINK_PARSE_STATE_GOT_BAD_CRC1) ||
+            (c != (uint8_t)(msg->checksum >> 8)))
+        {
+            framing = MAVLINK_FRAMING_BAD_CRC;
+        }
+        else
+        {
+            framing = MAVLINK_FRAMING_OK;
+        }
+#if MAVLINK_RX_SKIP_CRC
+        if ((self->rx_skip != 0u) && (st->parse_state == MAVLINK_PARSE_STATE_GOT_CRC1))
+        {
+            framing = MAVLINK_FRAMING_OK;
+        }
+#endif
+#if MAVLINK_RX_ACCEPT_UNKNOWN
+        if (self->rx_unknown != 0u)
+        {
+            framing = ((self->rx_unknown == MAVLINK_RX_UNKNOWN_FRAMING) ||
+                       MavlinkRx_CrcPlausible(msg->checksum, msg->ck[0], c)) ? MAVLINK_FRAMING_OK
+                                                                             : MAVLINK_FRAMING_BAD_CRC;
+            // The payload means nothing to us: header-only delivery
+            self->rx_skip = 1u;
+        }
+#endif
+        msg->ck[1] = c;
+
+        if ((msg->incompat_flags & MAVLINK_IFLAG_SIGNED) != 0u)
+        {
+            // A bad CRC is reported right away (mavlink_parse_char() then
+            // rescans the signature bytes for STX); a good one waits for
+            // the signature block.
+            st->signature_wait = MAVLINK_SIGNATURE_BLOCK_LEN;
+            if (framing == MAVLINK_FRAMING_BAD_CRC)
+            {
+                st->parse_state = MAVLINK_PARSE_STATE_SIGNATURE_WAIT_BAD_CRC;
+                break;
+            }
+            st->parse_state = MAVLINK_PARSE_STATE_SIGNATURE_WAIT;
+            framing = MAVLINK_FRAMING_INCOMPLETE;
+            break;
+        }
+
+        if ((st->signing != NULL) &&
+            ((st->signing->accept_unsigned_callback == NULL) ||
+             !st->signing->accept_unsigned_callback(st, msg->msgid)))
+        {
+            if (framing != MAVLINK_FRAMING_BAD_CRC)
+            {
+                framing = MAVLINK_FRAMING_BAD_SIGNATURE;
+            }
+        }
+        st->parse_state = MAVLINK_PARSE_STATE_IDLE;
+        break;
+
+    default:
+        st->parse_state = MAVLINK_PARSE_STATE_IDLE;
+        break;
+    }
+
+    return framing;
+}
+
+static uint8_t MavlinkRx_CheckSignature(MavlinkRx* self)
+{
+    mavlink_status_t* st = &self->mav_status;
+
+    // Only reached from SIGNATURE_WAIT, i.e. with a good CRC. A signed frame
+    // with a bad CRC is reported by MavlinkRx_ParseByte() before its
+    // signature bytes arrive; SIGNATURE_WAIT_BAD_CRC is transient there
+    // (MavlinkRx_FrameDone() resets parse_state), so no SHA is spent on it.
+#ifndef MAVLINK_NO_SIGNATURE_CHECK
+    bool sig_ok;
+    if (self->sign_link != NULL)
+    {
+        sig_ok = (MavlinkSign_Check(self->sign_link, self->rx_msg, HAL_GetTick()) == MAVLINK_SIGN_OK);
+    }
+    else
+    {
+        sig_ok = mavlink_signature_check(st->signing, st->signing_streams, self->rx_msg);
+    }
+#else
+    bool sig_ok = true;
+#endif
+    if (!sig_ok &&
+        (st->signing->accept_unsigned_callback != NULL) &&
+        st->signing->accept_unsigned_callback(st, self->rx_msg->msgid))
+    {
+        // Accepted via application level override
+        sig_ok = true;
+    }
+
+    st->parse_state = MAVLINK_PARSE_STATE_IDLE;
+
+    return sig_ok ? MAVLINK_FRAMING_OK : MAVLINK_FRAMING_BAD_SIGNATURE;
+}
+
+void MavlinkRx_SetInterest(MavlinkRx* self, uint32_t msgid, bool interested)
+{
+    if ((self == NULL) || (msgid >= MAVLINK_RX_INTEREST_IDS))
+    {
+        return;
+    }
+
+    if (interested)
+    {
+        self->interest[msgid >> 5] |= (1uL << (msgid & 31u));
+    }
+    else
+    {
+        self->interest[msgid >> 5] &= ~(1uL << (msgid & 31u));
+    }
+}
+
+void MavlinkRx_SetInterestAll(MavlinkRx* self, bool interested)
+{
+    if (self == NULL)
+    {
+        return;
+    }
+
+    (void)memset(self->interest, interested ? 0xFF : 0x00, sizeof(self->interest));
+}
+
+void MavlinkRx_SetOnSkipped(MavlinkRx* self, MavlinkRx_OnMessageFn fn, void* ctx)
+{
+    if (self == NULL)
+    {
+        return;
+    }
+
+    self->on_skipped = fn;
+    self->on_skipped_ctx = ctx;
+}
+
+// Index of the first spill entry with msgid >= the one given.
+static uint32_t MavlinkRx_SpillLowerBound(const MavlinkRx* self, uint32_t msgid)
+{
+    uint32_t lo = 0u;
+    uint32_t hi = self->sub_spill_count;
+
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2u;
+        if (self->sub_spill[mid].msgid < msgid)
+        {
+            lo = mid + 1u;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+static uint8_t MavlinkRx_SubHead(const MavlinkRx* self, uint32_t msgid)
+{
+    if (msgid < MAVLINK_RX_SUB_DIRECT_IDS)
+    {
+        return self->sub_direct[msgid];
+    }
+
+    uint32_t i = MavlinkRx_SpillLowerBound(self, msgid);
+    if ((i < self->sub_spill_count) && (self->sub_spill[i].msgid == msgid))
+    {
+        return self->sub_spill[i].head;
+    }
+
+    return 0u;
+}
+
+// Chain head for msgid, creating a spill entry if needed (NULL if full).
+static uint8_t* MavlinkRx_SubHeadSlot(MavlinkRx* self, uint32_t msgid)
+{
+    if (msgid == MAVLINK_RX_SUB_ANY)
+    {
+        return &self->sub_tap;
+    }
+
+    if (msgid < MAVLINK_RX_SUB_DIRECT_IDS)
+    {
+        return &self->sub_direct[msgid];
+    }
+
+    uint32_t i = MavlinkRx_SpillLowerBound(self, msgid);
+    if ((i < self->sub_spill_count) && (self->sub_spill[i].msgid == msgid))
+    {
+        return &self->sub_spill[i].head;
+    }
+
+    if (self->sub_spill_count >= MAVLINK_RX_SUB_SPILL)
+    {
+        return NULL;
+    }
+
+    (void)memmove(&self->sub_spill[i + 1u], &self->sub_spill[i],
+                  (self->sub_spill_count - i) * sizeof(self->sub_spill[0]));
+    self->sub_spill[i].msgid = msgid;
+    self->sub_spill[i].head = 0u;
+    self->sub_spill_count++;
+
+    return &self->sub_spill[i].head;
+}
+
+bool MavlinkRx_Subscribe(MavlinkRx* self, uint32_t msgid, MavlinkRx_OnMessageFn fn, void* ctx)
+{
+    if ((self == NULL) || (fn == NULL) || (self->sub_count >= MAVLINK_RX_SUB_MAX))
+    {
+        return false;
+    }
+
+    if ((msgid != MAVLINK_RX_SUB_ANY) && (mavlink_get_msg_entry(msgid) == NULL))
+    {
+        // Frames could never be validated: regenerate the msg table with it
+        Logger_Write(LOG_LEVEL_WARN, "MAV", "msgid %lu not in the CRC_EXTRA table", (unsigned long)msgid);
+        return false;
+    }
+
+    uint8_t* link = MavlinkRx_SubHeadSlot(self, msgid);
+    if (link == NULL)
+    {
+        return false;
+    }
+
+    // Append, so subscribers run in registration order.
+    while (*link != 0u)
+    {
+        link = &self->subs[*link - 1u].next;
+    }
+
+    MavlinkRx_Sub* sub = &self->subs[self->sub_count];
+    sub->fn = fn;
+    sub->ctx = ctx;
+    sub->next = 0u;
+    self->sub_count++;
+    *link = self->sub_count;
+
+    if (msgid != MAVLINK_RX_SUB_ANY)
+    {
+        MavlinkRx_SetInterest(self, msgid, true);
+    }
+
+    return true;
+}
+
+static void MavlinkRx_RunChain(const MavlinkRx* self, uint8_t idx, const mavlink_message_t* msg)
+{
+    while (idx != 0u)
+    {
+        const MavlinkRx_Sub* sub = &self->subs[idx - 1u];
+        sub->fn(sub->ctx, msg);
+        idx = sub->next;
+    }
+}
+
+bool MavlinkRx_RetainMessage(MavlinkRx* self, const mavlink_message_t* msg)
+{
+    if ((self == NULL) || (msg == NULL) || (msg != self->rx_msg))
+    {
+        return false;
+    }
+
+    // Hand the parser a fresh slot; the delivered one stays busy
+    for (uint32_t i = 0u; i < MAVLINK_RX_SLOT_COUNT; i++)
+    {
+        if ((self->slot_busy & (1uL << i)) == 0u)
+        {
+            self->slot_busy |= (1uL << i);
+            self->rx_msg = &self->slots[i];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void MavlinkRx_ReleaseMessage(MavlinkRx* self, const mavlink_message_t* msg)
+{
+    if ((self == NULL) || (msg == NULL) || (msg == self->rx_msg))
+    {
+        return;
+    }
+
+    if ((msg < &self->slots[0]) || (msg >= &self->slots[MAVLINK_RX_SLOT_COUNT]))
+    {
+        return;
+    }
+
+    self->slot_busy &= ~(1uL << (uint32_t)(msg - &self->slots[0]));
+}
+
+void MavlinkRx_GetStats(MavlinkRx* self, MavlinkRx_Stats* out_stats, uint8_t reset)
+{
+    if ((self == NULL) || (out_stats == NULL))
+    {
+        return;
+    }
+
+    // Parsing runs in the main loop only, so a plain copy is consistent
+    *out_stats = self->stats;
+    if (reset != 0u)
+    {
+        (void)memset(&self->stats, 0, sizeof(self->stats));
+    }
+}
+
+void MavlinkRx_SetSigning(MavlinkRx* self, MavlinkSign_Link* link)
+{
+    if (self == NULL)
+    {
+        return;
+    }
+
+    self->sign_link = link;
+    if (link != NULL)
+    {
+        self->mav_status.signing = &link->signing;
+        self->mav_status.signing_streams = &link->streams;
+    }
+    else
+    {
+        self->mav_status.signing = NULL;
+        self->mav_status.signing_streams = NULL;
+    }
+}
+
+uint8_t MavlinkRx_GetChannel(const MavlinkRx* self)
+{
+    if (self == NULL)
+    {
+        return MAVLINK_RX_NO_CHANNEL;
+    }
+
+    return self->chan;
+}
+
+void MavlinkRx_ReleaseChannel(MavlinkRx* self)
+{
+    if ((self == NULL) || (self->chan >= MAVLINK_COMM_NUM_BUFFERS))
+    {
+        return;
+    }
+
+    if (s_channel_owner[self->chan] == self)
+    {
+        s_channel_owner[self->chan] = NULL;
+    }
+    self->chan = MAVLINK_RX_NO_CHANNEL;
+}
+
+bool MavlinkRx_IsValidated(const MavlinkRx* self)
+{
+    if (self == NULL)
+    {
+        return false;
+    }
+
+#if MAVLINK_RX_SKIP_CRC
+    if (self->rx_skip != 0u)
+    {
+        return false;
+    }
+#endif
+    return (self->rx_unknown == 0u);
+}
+
+// Frame finished. last is the final byte of the frame: like
+// mavlink_parse_char(), a rejected frame ending in a v2 STX restarts
+// framing on that byte.
+static uint32_t MavlinkRx_FrameDone(MavlinkRx* self, uint8_t framing, uint8_t last)
+{
+    mavlink_status_t* st = &self->mav_status;
+
+    if (framing != MAVLINK_FRAMING_OK)
+    {
+        uint32_t* reason = &self->stats.bad_signature;
+        if (framing == MAVLINK_FRAMING_BAD_CRC)
+        {
+            // A table miss is only a dialect problem when no check was
+            // possible; failing the CRC-bits check (rx_unknown) is corruption.
+            reason = &self->stats.bad_crc;
+            if ((self->rx_unknown == 0u) && (mavlink_get_msg_entry(self->rx_msg->msgid) == NULL))
+            {
+                reason = &self->stats.unknown_msgid;
+            }
+        }
+        MavlinkRx_ParseError(self, reason);
+        st->parse_state = MAVLINK_PARSE_STATE_IDLE;
+        if (last == MAVLINK_STX)
+        {
+            st->parse_state = MAVLINK_PARSE_STATE_GOT_STX;
+            self->rx_msg->len = 0u;
+            mavlink_start_checksum(self->rx_msg);
+        }
+        return 0u;
+    }
+
+    st->current_rx_seq = self->rx_msg->seq;
+    if (st->packet_rx_success_count == 0u)
+    {
+        st->packet_rx_drop_count = 0u;
+    }
+    st->packet_rx_success_count++;
+
+    if (self->rx_msg->magic == MAVLINK_STX_MAVLINK1)
+    {
+        self->stats.frames_v1++;
+    }
+    else
+    {
+        self->stats.frames_v2++;
+        if ((self->rx_msg->incompat_flags & MAVLINK_IFLAG_SIGNED) != 0u)
+        {
+            self->stats.frames_signed++;
+        }
+    }
+
+    if (self->rx_skip != 0u)
+    {
+        self->stats.frames_skipped++;
+        if (self->rx_unknown != 0u)
+        {
+            self->stats.frames_unvalidated++;
+        }
+        if (self->on_skipped != NULL)
+        {
+            self->on_skipped(self->on_skipped_ctx, self->rx_msg);
+        }
+        return 0u;
+    }
+
+    // Any handler may retain the frame, which moves rx_msg to a new slot.
+    const mavlink_message_t* msg = self->rx_msg;
+    MavlinkRx_RunChain(self, self->sub_tap, msg);
+    MavlinkRx_RunChain(self, MavlinkRx_SubHead(self, msg->msgid), msg);
+
+    if (self->on_message != NULL)
+    {
+        self->on_message(self->on_message_ctx, msg);
+    }
+    return 1u;
+}
+
+#if MAVLINK_RX_RESYNC
+// Append consumed frame bytes to the lookback buffer. During a rescan the
+// source is the buffer itself, always at or after the write position.
+static void MavlinkRx_Record(MavlinkRx* self, const uint8_t* from, const uint8_t* to)
+{
+    size_t n = (size_t)(to - from);
+    if (n > (sizeof(self->resync_buf) - self->resync_len))
+    {
+        n = sizeof(self->resync_buf) - self->resync_len;
+    }
+
+    (void)memmove(&self->resync_buf[self->resync_len], from, n);
+    self->resync_len = (uint16_t)(self->resync_len + n);
+}
+#endif
+
+// Parser proper. With resync on it stops right after a rejected frame;
+// *out_used is the number of bytes consumed.
+static uint32_t MavlinkRx_ParseCore(MavlinkRx* self, const uint8_t* data, size_t len, size_t* out_used)
+{
+    mavlink_status_t* st = &self->mav_status;
+    mavlink_message_t* msg = self->rx_msg;
+    const uint8_t* p = data;
+    const uint8_t* end = data + len;
+    uint32_t delivered = 0u;
+
+#if MAVLINK_RX_RESYNC
+    while ((p < end) && (self->rx_rejected == 0u))
+#else
+    while (p < end)
+#endif
+    {
+#if MAVLINK_RX_RESYNC
+        const uint8_t* rec = p;
+#endif
+        switch (st->parse_state)
+        {
+        case MAVLINK_PARSE_STATE_UNINIT:
+        case MAVLINK_PARSE_STATE_IDLE:
+        {
+            // Outside a frame only STX matters
+            const uint8_t* hunt = p;
+            while ((p < end) && (*p != MAVLINK_STX) && (*p != MAVLINK_STX_MAVLINK1))
+            {
+                p++;
+            }
+            self->stats.bytes_discarded += (uint32_t)(p - hunt);
+            if (p < end)
+            {
+#if MAVLINK_RX_RESYNC
+                rec = p;
+                self->resync_len = 0u;
+#endif
+                MavlinkRx_StartFrame(self, *p);
+#if !defined(MAVLINK_CHECK_MESSAGE_LENGTH) && (MAVLINK_MAX_PAYLOAD_LEN >= 255)
+                // Whole header in this span: take it in one go
+                size_t hdr_len = 1u + (((st->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) != 0u)
+                                       ? MAVLINK_CORE_HEADER_MAVLINK1_LEN
+                                       : MAVLINK_CORE_HEADER_LEN);
+                if (((size_t)(end - p) >= hdr_len) && MavlinkRx_ParseHeader(self, p))
                 {
-                    self->on_message(self->on_message_ctx, &msg);
+                    p += hdr_len;
+                    break;
                 }
+#endif
+                p++;
+            }
+            break;
+        }
+
+        case MAVLINK_PARSE_STATE_GOT_MSGID3:
+        {
+            // Payload: one copy and one CRC pass over what is available
+            size_t n = (size_t)(msg->len - st->packet_idx);
+            if (n > (size_t)(end - p))
+            {
+                n = (size_t)(end - p);
+            }
+
+            if (self->rx_skip == 0u)
+            {
+                (void)memcpy(&_MAV_PAYLOAD_NON_CONST(msg)[st->packet_idx], p, n);
+            }
+#if MAVLINK_RX_SKIP_CRC
+            if (self->rx_skip == 0u)
+#endif
+            {
+                uint16_t crc = msg->checksum;
+                MavlinkCrc_AccumulateBuffer(&crc, p, n);
+                msg->checksum = crc;
+            }
+
+            st->packet_idx = (uint8_t)(st->packet_idx + n);
+            p += n;
+            if (st->packet_idx == msg->len)
+            {
+                st->parse_state = MAVLINK_PARSE_STATE_GOT_PAYLOAD;
+            }
+            break;
+        }
+
+        case MAVLINK_PARSE_STATE_SIGNATURE_WAIT:
+        {
+            size_t n = st->signature_wait;
+            if (n > (size_t)(end - p))
+            {
+                n = (size_t)(end - p);
+            }
+
+            (void)memcpy(&msg->signature[MAVLINK_SIGNATURE_BLOCK_LEN - st->signature_wait], p, n);
+            st->signature_wait = (uint8_t)(st->signature_wait - n);
+            p += n;
+            if (st->signature_wait == 0u)
+            {
+                delivered += MavlinkRx_FrameDone(self, MavlinkRx_CheckSignature(self), p[-1]);
+                msg = self->rx_msg;
+            }
+            break;
+        }
+
+        default:
+        {
+            uint8_t framing = MavlinkRx_ParseByte(self, *p);
+            p++;
+            if (framing != MAVLINK_FRAMING_INCOMPLETE)
+            {
+                delivered += MavlinkRx_FrameDone(self, framing, p[-1]);
+                msg = self->rx_msg;
             }
+            break;
+        }
+        }
+
+#if MAVLINK_RX_RESYNC
+        if (self->resync_enabled != 0u)
+        {
+            MavlinkRx_Record(self, rec, p);
         }
+#endif
+    }
+
+    *out_used = (size_t)(p - data);
+    return delivered;
+}
+
+#if MAVLINK_RX_RESYNC
+// Rescan the bytes of a rejected frame, starting one byte after its STX.
+// A candidate found there may itself be rejected (its bytes then become
+// the new lookback, followed by the bytes not yet rescanned), so repeat
+// until the lookback is exhausted or ends in a frame still in progress.
+static uint32_t MavlinkRx_Resync(MavlinkRx* self)
+{
+    uint8_t* buf = self->resync_buf;
+    size_t n = self->resync_len;
+    uint32_t delivered = 0u;
+
+    while ((self->rx_rejected != 0u) && (n > 1u))
+    {
+        size_t used = 0u;
+
+        self->rx_rejected = 0u;
+        self->mav_status.parse_state = MAVLINK_PARSE_STATE_IDLE;
+        self->resync_len = 0u;
+        delivered += MavlinkRx_ParseCore(self, &buf[1], n - 1u, &used);
+        used += 1u;
+
+        if (self->rx_rejected != 0u)
+        {
+            size_t kept = self->resync_len;
+            (void)memmove(&buf[kept], &buf[used], n - used);
+            n = kept + (n - used);
+        }
+    }
+
+    if (self->rx_rejected != 0u)
+    {
+        // Nothing left to rescan
+        self->rx_rejected = 0u;
+        self->mav_status.parse_state = MAVLINK_PARSE_STATE_IDLE;
+        self->resync_len = 0u;
+    }
+
+    return delivered;
+}
+
+void MavlinkRx_SetResync(MavlinkRx* self, bool enabled)
+{
+    if (self == NULL)
+    {
+        return;
+    }
+
+    self->resync_enabled = enabled ? 1u : 0u;
+    self->rx_rejected = 0u;
+    self->resync_len = 0u;
+}
+#endif
+
+uint32_t MavlinkRx_ParseSpan(MavlinkRx* self, const uint8_t* data, size_t len)
+{
+    if ((self == NULL) || (data == NULL))
+    {
+        return 0u;
+    }
+
+    uint32_t delivered = 0u;
+    size_t used = 0u;
+
+    delivered += MavlinkRx_ParseCore(self, data, len, &used);
+#if MAVLINK_RX_RESYNC
+    while (self->rx_rejected != 0u)
+    {
+        uint32_t recovered = MavlinkRx_Resync(self);
+        self->stats.frames_recovered += recovered;
+        delivered += recovered;
+        data += used;
+        len -= used;
+        delivered += MavlinkRx_ParseCore(self, data, len, &used);
+    }
+#endif
+
+    return delivered;
+}
+#endif
+
+void MavlinkRx_Update(MavlinkRx* self)
+{
+    if (self == NULL)
+    {
+        return;
+    }
+
+#if !UART_RX_RING_IDLE_DMA
+    // Move new bytes from DMA circular buffer into SW ring buffer
+    // (in IDLE DMA mode the RX event callback already did it)
+    UartRxRing_PollFromDma(&self->rx_ring);
+#endif
+
+    // Parse directly from SW ring memory (no intermediate copy).
+    // Bytes are committed only after they were fed to the parser.
+    UartRxRing_Span spans[2];
+
+    while (UartRxRing_Peek(&self->rx_ring, &spans[0], &spans[1]) > 0u)
+    {
+#ifdef USE_MAVLINK_C_LIB
+        (void)MavlinkRx_ParseSpan(self, spans[0].data, spans[0].len);
+        (void)MavlinkRx_ParseSpan(self, spans[1].data, spans[1].len);
 
         //DIAG
 //        static uint32_t s_last_log_ms = 0u;
@@ -109,7 +1169,8 @@ void MavlinkRx_Update(MavlinkRx* self)
 #else
         // No MAVLink library yet: just consume bytes.
         // Callback not called in this mode.
-        (void)buf;
 #endif
+
+        UartRxRing_Commit(&self->rx_ring, (uint16_t)(spans[0].len + spans[1].len));
     }
 }
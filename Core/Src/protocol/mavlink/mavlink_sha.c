@@ -0,0 +1,164 @@
+#include "mavlink_sha.h"
+#include <string.h>
+
+static const uint32_t s_k[64] =
+{
+    0x428A2F98u, 0x71374491u, 0xB5C0FBCFu, 0xE9B5DBA5u, 0x3956C25Bu, 0x59F111F1u, 0x923F82A4u, 0xAB1C5ED5u,
+    0xD807AA98u, 0x12835B01u, 0x243185BEu, 0x550C7DC3u, 0x72BE5D74u, 0x80DEB1FEu, 0x9BDC06A7u, 0xC19BF174u,
+    0xE49B69C1u, 0xEFBE4786u, 0x0FC19DC6u, 0x240CA1CCu, 0x2DE92C6Fu, 0x4A7484AAu, 0x5CB0A9DCu, 0x76F988DAu,
+    0x983E5152u, 0xA831C66Du, 0xB00327C8u, 0xBF597FC7u, 0xC6E00BF3u, 0xD5A79147u, 0x06CA6351u, 0x14292967u,
+    0x27B70A85u, 0x2E1B2138u, 0x4D2C6DFCu, 0x53380D13u, 0x650A7354u, 0x766A0ABBu, 0x81C2C92Eu, 0x92722C85u,
+    0xA2BFE8A1u, 0xA81A664Bu, 0xC24B8B70u, 0xC76C51A3u, 0xD192E819u, 0xD6990624u, 0xF40E3585u, 0x106AA070u,
+    0x19A4C116u, 0x1E376C08u, 0x2748774Cu, 0x34B0BCB5u, 0x391C0CB3u, 0x4ED8AA4Au, 0x5B9CCA4Fu, 0x682E6FF3u,
+    0x748F82EEu, 0x78A5636Fu, 0x84C87814u, 0x8CC70208u, 0x90BEFFFAu, 0xA4506CEBu, 0xBEF9A3F7u, 0xC67178F2u
+};
+
+#define SHA_ROTR(x, n)  (((x) >> (n)) | ((x) << (32 - (n))))
+#define SHA_S0(x)       (SHA_ROTR((x), 2) ^ SHA_ROTR((x), 13) ^ SHA_ROTR((x), 22))
+#define SHA_S1(x)       (SHA_ROTR((x), 6) ^ SHA_ROTR((x), 11) ^ SHA_ROTR((x), 25))
+#define SHA_s0(x)       (SHA_ROTR((x), 7) ^ SHA_ROTR((x), 18) ^ ((x) >> 3))
+#define SHA_s1(x)       (SHA_ROTR((x), 17) ^ SHA_ROTR((x), 19) ^ ((x) >> 10))
+#define SHA_CH(e, f, g)  ((g) ^ ((e) & ((f) ^ (g))))
+#define SHA_MAJ(a, b, c) (((a) & (b)) | ((c) & ((a) | (b))))
+
+// Rolling schedule: w[i & 15] is replaced by W[i] for rounds 16..63
+#define SHA_W(i) \
+    (w[(i) & 15u] += SHA_s1(w[((i) - 2u) & 15u]) + w[((i) - 7u) & 15u] + SHA_s0(w[((i) - 15u) & 15u]))
+
+// One round with the working variables renamed instead of shifted
+#define SHA_ROUND(a, b, c, d, e, f, g, h, i, wi)                       \
+    do                                                                  \
+    {                                                                   \
+        uint32_t t1 = (h) + SHA_S1(e) + SHA_CH((e), (f), (g)) + s_k[(i)] + (wi); \
+        (d) += t1;                                                      \
+        (h) = t1 + SHA_S0(a) + SHA_MAJ((a), (b), (c));                  \
+    } while (0)
+
+#define SHA_ROUNDS8(i, W)                                               \
+    SHA_ROUND(a, b, c, d, e, f, g, h, (i) + 0u, W((i) + 0u));           \
+    SHA_ROUND(h, a, b, c, d, e, f, g, (i) + 1u, W((i) + 1u));           \
+    SHA_ROUND(g, h, a, b, c, d, e, f, (i) + 2u, W((i) + 2u));           \
+    SHA_ROUND(f, g, h, a, b, c, d, e, (i) + 3u, W((i) + 3u));           \
+    SHA_ROUND(e, f, g, h, a, b, c, d, (i) + 4u, W((i) + 4u));           \
+    SHA_ROUND(d, e, f, g, h, a, b, c, (i) + 5u, W((i) + 5u));           \
+    SHA_ROUND(c, d, e, f, g, h, a, b, (i) + 6u, W((i) + 6u));           \
+    SHA_ROUND(b, c, d, e, f, g, h, a, (i) + 7u, W((i) + 7u))
+
+#define SHA_W_LOADED(i) w[(i)]
+
+static inline uint32_t MavlinkSha_LoadBe32(const uint8_t* p)
+{
+    uint32_t v;
+    (void)memcpy(&v, p, sizeof(v));     // single (unaligned) LDR on Cortex-M4
+    return __builtin_bswap32(v);        // REV
+}
+
+static void MavlinkSha_Compress(uint32_t state[8], const uint8_t* data)
+{
+    uint32_t w[16];
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+    uint32_t f = state[5];
+    uint32_t g = state[6];
+    uint32_t h = state[7];
+
+    for (uint32_t i = 0u; i < 16u; i++)
+    {
+        w[i] = MavlinkSha_LoadBe32(&data[4u * i]);
+    }
+
+    SHA_ROUNDS8(0u, SHA_W_LOADED);
+    SHA_ROUNDS8(8u, SHA_W_LOADED);
+    for (uint32_t i = 16u; i < 64u; i += 16u)
+    {
+        SHA_ROUNDS8(i, SHA_W);
+        SHA_ROUNDS8(i + 8u, SHA_W);
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void mavlink_sha256_init(mavlink_sha256_ctx* m)
+{
+    m->state[0] = 0x6A09E667u;
+    m->state[1] = 0xBB67AE85u;
+    m->state[2] = 0x3C6EF372u;
+    m->state[3] = 0xA54FF53Au;
+    m->state[4] = 0x510E527Fu;
+    m->state[5] = 0x9B05688Cu;
+    m->state[6] = 0x1F83D9ABu;
+    m->state[7] = 0x5BE0CD19u;
+    m->count = 0u;
+}
+
+void mavlink_sha256_update(mavlink_sha256_ctx* m, const void* v, uint32_t len)
+{
+    const uint8_t* p = (const uint8_t*)v;
+    uint32_t used = m->count & 63u;
+
+    m->count += len;
+
+    // Top up a pending partial block first
+    if (used != 0u)
+    {
+        uint32_t n = 64u - used;
+        if (n > len)
+        {
+            n = len;
+        }
+        (void)memcpy(&m->block.bytes[used], p, n);
+        p += n;
+        len -= n;
+        if ((used + n) < 64u)
+        {
+            return;
+        }
+        MavlinkSha_Compress(m->state, m->block.bytes);
+    }
+
+    // Whole blocks straight from the input
+    while (len >= 64u)
+    {
+        MavlinkSha_Compress(m->state, p);
+        p += 64u;
+        len -= 64u;
+    }
+
+    (void)memcpy(m->block.bytes, p, len);
+}
+
+void mavlink_sha256_final_48(mavlink_sha256_ctx* m, uint8_t result[6])
+{
+    uint32_t used = m->count & 63u;
+    uint32_t bits_hi = m->count >> 29;
+    uint32_t bits_lo = m->count << 3;
+
+    m->block.bytes[used++] = 0x80u;
+    if (used > 56u)
+    {
+        (void)memset(&m->block.bytes[used], 0, 64u - used);
+        MavlinkSha_Compress(m->state, m->block.bytes);
+        used = 0u;
+    }
+    (void)memset(&m->block.bytes[used], 0, 56u - used);
+    m->block.words[14] = __builtin_bswap32(bits_hi);
+    m->block.words[15] = __builtin_bswap32(bits_lo);
+    MavlinkSha_Compress(m->state, m->block.bytes);
+
+    result[0] = (uint8_t)(m->state[0] >> 24);
+    result[1] = (uint8_t)(m->state[0] >> 16);
+    result[2] = (uint8_t)(m->state[0] >> 8);
+    result[3] = (uint8_t)(m->state[0]);
+    result[4] = (uint8_t)(m->state[1] >> 24);
+    result[5] = (uint8_t)(m->state[1] >> 16);
+}
@@ -0,0 +1,224 @@
+#include "mavlink_sign.h"
+#include <string.h>
+
+// 10 us timestamp ticks per millisecond
+#define MAVLINK_SIGN_TICKS_PER_MS 100u
+
+static void MavlinkSign_Wipe(uint8_t* p, uint32_t len)
+{
+    // volatile so the stores are not dropped as dead
+    volatile uint8_t* v = p;
+    for (uint32_t i = 0u; i < len; i++)
+    {
+        v[i] = 0u;
+    }
+}
+
+static uint64_t MavlinkSign_ReadTimestamp(const uint8_t* p)
+{
+    uint64_t t = 0u;
+    for (uint32_t i = 0u; i < 6u; i++)
+    {
+        t |= ((uint64_t)p[i]) << (8u * i);
+    }
+    return t;
+}
+
+// Signature of msg under key, compared in constant time
+static bool MavlinkSign_Matches(const uint8_t* key, const mavlink_message_t* msg)
+{
+    mavlink_sha256_ctx ctx;
+    uint8_t sig[6];
+    uint8_t diff = 0u;
+
+    mavlink_sha256_init(&ctx);
+    mavlink_sha256_update(&ctx, key, MAVLINK_SIGN_KEY_LEN);
+    mavlink_sha256_update(&ctx, &msg->magic, MAVLINK_NUM_HEADER_BYTES);
+    mavlink_sha256_update(&ctx, _MAV_PAYLOAD(msg), msg->len);
+    mavlink_sha256_update(&ctx, msg->ck, 2u);
+    mavlink_sha256_update(&ctx, msg->signature, 7u);
+    mavlink_sha256_final_48(&ctx, sig);
+
+    for (uint32_t i = 0u; i < 6u; i++)
+    {
+        diff |= (uint8_t)(sig[i] ^ msg->signature[7u + i]);
+    }
+    return (diff == 0u);
+}
+
+static MavlinkSign_Result MavlinkSign_CheckKey(MavlinkSign_Link* self, const mavlink_message_t* msg)
+{
+    const MavlinkSign_KeyStore* keys = self->keys;
+    if ((keys == NULL) || (keys->valid == 0u))
+    {
+        return MAVLINK_SIGN_NO_KEY;
+    }
+
+    // Key in use first, then the others: the sender may have rotated keys
+    for (uint8_t n = 0u; n < MAVLINK_SIGN_KEY_SLOTS; n++)
+    {
+        uint8_t slot = (uint8_t)((self->key_slot + n) % MAVLINK_SIGN_KEY_SLOTS);
+        if (((keys->valid & (1u << slot)) != 0u) && MavlinkSign_Matches(keys->key[slot], msg))
+        {
+            if (n != 0u)
+            {
+                self->key_slot = slot;
+                (void)memcpy(self->signing.secret_key, keys->key[slot], MAVLINK_SIGN_KEY_LEN);
+            }
+            return MAVLINK_SIGN_OK;
+        }
+    }
+
+    return MAVLINK_SIGN_BAD_SIGNATURE;
+}
+
+static MavlinkSign_Result MavlinkSign_CheckTimestamp(MavlinkSign_Link* self, const mavlink_message_t* msg)
+{
+    mavlink_signing_streams_t* streams = &self->streams;
+    const uint8_t link_id = msg->signature[0];
+    const uint64_t t = MavlinkSign_ReadTimestamp(&msg->signature[1]);
+    uint16_t i;
+
+    if (self->synced &&
+        (t > (self->signing.timestamp + ((uint64_t)MAVLINK_SIGN_WINDOW_MS * MAVLINK_SIGN_TICKS_PER_MS))))
+    {
+        return MAVLINK_SIGN_FUTURE_TIMESTAMP;
+    }
+
+    for (i = 0u; i < streams->num_signing_streams; i++)
+    {
+        if ((streams->stream[i].sysid == msg->sysid) &&
+            (streams->stream[i].compid == msg->compid) &&
+            (streams->stream[i].link_id == link_id))
+        {
+            break;
+        }
+    }
+
+    if (i == streams->num_signing_streams)
+    {
+        if (streams->num_signing_streams >= MAVLINK_MAX_SIGNING_STREAMS)
+        {
+            return MAVLINK_SIGN_TOO_MANY_STREAMS;
+        }
+        if ((t + ((uint64_t)MAVLINK_SIGNING_TIMESTAMP_LIMIT * 1000u * MAVLINK_SIGN_TICKS_PER_MS)) <
+            self->signing.timestamp)
+        {
+            return MAVLINK_SIGN_OLD_TIMESTAMP;
+        }
+        streams->stream[i].sysid = msg->sysid;
+        streams->stream[i].compid = msg->compid;
+        streams->stream[i].link_id = link_id;
+        streams->num_signing_streams++;
+    }
+    else if (t <= MavlinkSign_ReadTimestamp(streams->stream[i].timestamp_bytes))
+    {
+        return MAVLINK_SIGN_REPLAY;
+    }
+
+    (void)memcpy(streams->stream[i].timestamp_bytes, &msg->signature[1], 6u);
+    if (t > self->signing.timestamp)
+    {
+        self->signing.timestamp = t;
+    }
+    self->synced = true;
+
+    return MAVLINK_SIGN_OK;
+}
+
+void MavlinkSign_KeyStoreInit(MavlinkSign_KeyStore* self)
+{
+    if (self == NULL)
+    {
+        return;
+    }
+
+    MavlinkSign_Wipe(&self->key[0][0], (uint32_t)sizeof(self->key));
+    self->valid = 0u;
+}
+
+bool MavlinkSign_KeyStoreSet(MavlinkSign_KeyStore* self, uint8_t slot, const uint8_t key[MAVLINK_SIGN_KEY_LEN])
+{
+    if ((self == NULL) || (key == NULL) || (slot >= MAVLINK_SIGN_KEY_SLOTS))
+    {
+        return false;
+    }
+
+    (void)memcpy(self->key[slot], key, MAVLINK_SIGN_KEY_LEN);
+    self->valid |= (uint8_t)(1u << slot);
+    return true;
+}
+
+void MavlinkSign_KeyStoreClear(MavlinkSign_KeyStore* self, uint8_t slot)
+{
+    if ((self == NULL) || (slot >= MAVLINK_SIGN_KEY_SLOTS))
+    {
+        return;
+    }
+
+    MavlinkSign_Wipe(self->key[slot], MAVLINK_SIGN_KEY_LEN);
+    self->valid &= (uint8_t)~(1u << slot);
+}
+
+void MavlinkSign_LinkInit(MavlinkSign_Link* self, const MavlinkSign_KeyStore* keys,
+                          uint8_t key_slot, uint8_t link_id)
+{
+    if (self == NULL)
+    {
+        return;
+    }
+
+    (void)memset(self, 0, sizeof(*self));
+    self->keys = keys;
+    self->key_slot = (key_slot < MAVLINK_SIGN_KEY_SLOTS) ? key_slot : 0u;
+    self->signing.link_id = link_id;
+    if (keys != NULL)
+    {
+        (void)memcpy(self->signing.secret_key, keys->key[self->key_slot], MAVLINK_SIGN_KEY_LEN);
+    }
+}
+
+void MavlinkSign_SetTimestamp(MavlinkSign_Link* self, uint64_t timestamp, uint32_t now_ms)
+{
+    if (self == NULL)
+    {
+        return;
+    }
+
+    self->signing.timestamp = timestamp;
+    self->clock_ms = now_ms;
+    self->synced = true;
+}
+
+MavlinkSign_Result MavlinkSign_Check(MavlinkSign_Link* self, const mavlink_message_t* msg, uint32_t now_ms)
+{
+    if ((self == NULL) || (msg == NULL))
+    {
+        return MAVLINK_SIGN_BAD_SIGNATURE;
+    }
+
+    // Run the link clock on local time between frames
+    if (self->synced)
+    {
+        self->signing.timestamp += (uint64_t)(now_ms - self->clock_ms) * MAVLINK_SIGN_TICKS_PER_MS;
+    }
+    self->clock_ms = now_ms;
+
+    MavlinkSign_Result res = MavlinkSign_CheckKey(self, msg);
+    if (res == MAVLINK_SIGN_OK)
+    {
+        res = MavlinkSign_CheckTimestamp(self, msg);
+    }
+
+    self->results[res]++;
+    switch (res)
+    {
+        case MAVLINK_SIGN_OK:               self->signing.last_status = MAVLINK_SIGNING_STATUS_OK; break;
+        case MAVLINK_SIGN_TOO_MANY_STREAMS: self->signing.last_status = MAVLINK_SIGNING_STATUS_TOO_MANY_STREAMS; break;
+        case MAVLINK_SIGN_OLD_TIMESTAMP:    self->signing.last_status = MAVLINK_SIGNING_STATUS_OLD_TIMESTAMP; break;
+        case MAVLINK_SIGN_REPLAY:           self->signing.last_status = MAVLINK_SIGNING_STATUS_REPLAY; break;
+        default:                            self->signing.last_status = MAVLINK_SIGNING_STATUS_BAD_SIGNATURE; break;
+    }
+
+    return res;
+}
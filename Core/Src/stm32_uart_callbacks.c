@@ -1,5 +1,6 @@
 #include "stm32_uart_callbacks.h"
 #include "logger_sink.h"
+#include "uart_rx_ring.h"
 
 /*
  * NOTE:
@@ -17,11 +18,36 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart)
     // GpsUart_OnTxComplete(huart);
 }
 
+void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef* huart)
+{
+    // Route to RX rings (DMA lap detection)
+    UartRxRing_OnDmaBoundary(huart);
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart)
+{
+    // Route to RX rings (DMA lap detection)
+    UartRxRing_OnDmaBoundary(huart);
+}
+
 void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart)
 {
     // Route to logger UART sink
     LoggerSinkUart_OnError(huart);
 
-    // Future:
-    // MavlinkUart_OnError(huart);
+#if UART_RX_RING_IDLE_DMA || UART_RX_RING_PINGPONG_DMA
+    // Route to RX rings (restarts IDLE / ping-pong DMA reception)
+    UartRxRing_OnError(huart);
+#endif
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t Size)
+{
+#if UART_RX_RING_IDLE_DMA
+    // Route to RX rings (IDLE line, DMA half/full transfer)
+    UartRxRing_OnRxEvent(huart, Size);
+#else
+    (void)huart;
+    (void)Size;
+#endif
 }
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""Generate the O(1) MAVLink message entry index used by mavlink_msg_entry.c.
+
+Reads MAVLINK_MESSAGE_CRCS from a generated dialect header and emits:
+  - a direct index for msgid < LOW_SIZE (entry index + 1, 0 = unknown)
+  - a multiplicative perfect hash for the sparse msgids >= LOW_SIZE
+
+Entries are referenced by their position in MAVLINK_MESSAGE_CRCS, so the
+C side keeps using the dialect's own table for the entry data.
+
+With --keep the table is trimmed to the listed messages (names as in
+MAVLINK_MESSAGE_NAMES, or numeric ids). The kept entries are copied into
+the output and every msgid goes through the perfect hash, so neither the
+dialect table nor the 512-byte direct index is linked. Frames with any
+other msgid can no longer be CRC-checked: MavlinkRx rejects them unless
+built with MAVLINK_RX_ACCEPT_UNKNOWN=1, which accepts them on a weak 8-bit
+check (about 1 in 256 random frames passes). Trimming is opt-in; the
+checked-in index covers the full dialect.
+
+Usage:
+  scripts/gen_mavlink_msg_index.py [--keep NAME,...] [dialect.h] [output.h]
+
+Trimmed to the messages decoded by telemetry.c:
+  scripts/gen_mavlink_msg_index.py --keep HEARTBEAT,SYS_STATUS,GPS_RAW_INT
+"""
+
+import argparse
+import os
+import random
+import re
+import sys
+
+LOW_SIZE = 512
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_DIALECT = os.path.join(REPO, "Core", "Inc", "mavlink", "common", "common.h")
+DEFAULT_OUTPUT = os.path.join(REPO, "Core", "Src", "protocol", "mavlink", "mavlink_msg_index_gen.h")
+
+
+def read_entries(path):
+    text = open(path).read()
+    m = re.search(r"#define MAVLINK_MESSAGE_CRCS (\{.*\})", text)
+    if m is None:
+        sys.exit("MAVLINK_MESSAGE_CRCS not found in %s" % path)
+    entries = [tuple(int(v) for v in e.split(","))
+               for e in re.findall(r"\{(\d+(?:,\s*\d+){6})\}", m.group(1))]
+    ids = [e[0] for e in entries]
+    if ids != sorted(set(ids)):
+        sys.exit("MAVLINK_MESSAGE_CRCS is not sorted/unique")
+    return entries
+
+
+def read_names(path):
+    text = open(path).read()
+    m = re.search(r"#\s*define MAVLINK_MESSAGE_NAMES (\{.*\})", text)
+    if m is None:
+        sys.exit("MAVLINK_MESSAGE_NAMES not found in %s" % path)
+    return {name: int(msgid) for name, msgid in re.findall(r'\{\s*"(\w+)",\s*(\d+)\s*\}', m.group(1))}
+
+
+def resolve_keep(keep, entries, names):
+    known = {e[0] for e in entries}
+    ids = set()
+    for item in keep.split(","):
+        item = item.strip()
+        if not item:
+            continue
+        msgid = int(item) if item.isdigit() else names.get(item.upper())
+        if msgid is None or msgid not in known:
+            sys.exit("--keep: %s is not in the dialect" % item)
+        ids.add(msgid)
+    if not ids:
+        sys.exit("--keep: no messages listed")
+    by_id = {v: k for k, v in names.items()}
+    return [e for e in entries if e[0] in ids], [by_id.get(i, str(i)) for i in sorted(ids)]
+
+
+def hash_slot(msgid, mult, bits):
+    return ((msgid * mult) & 0xFFFFFFFF) >> (32 - bits)
+
+
+def find_hash(ids):
+    # Smallest power-of-two table with a collision-free odd multiplier
+    bits = 1
+    while (1 << bits) < len(ids):
+        bits += 1
+    rng = random.Random(0x4D41564C)  # fixed seed: reproducible output
+    while True:
+        for _ in range(200000):
+            mult = rng.getrandbits(32) | 1
+            slots = {hash_slot(i, mult, bits) for i in ids}
+            if len(slots) == len(ids):
+                return mult, bits
+        bits += 1
+
+
+def fmt_table(values, per_line):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join("%3du" % v for v in values[i:i + per_line]) + ",")
+    lines[-1] = lines[-1].rstrip(",")
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate mavlink_msg_index_gen.h")
+    parser.add_argument("--keep", help="comma-separated message names or ids to keep")
+    parser.add_argument("dialect", nargs="?", default=DEFAULT_DIALECT)
+    parser.add_argument("output", nargs="?", default=DEFAULT_OUTPUT)
+    args = parser.parse_args()
+    dialect = args.dialect
+    output = args.output
+
+    entries = read_entries(dialect)
+    dialect_count = len(entries)
+    kept_names = None
+    low_size = LOW_SIZE
+    if args.keep:
+        entries, kept_names = resolve_keep(args.keep, entries, read_names(dialect))
+        low_size = 0  # a handful of ids: the hash alone is smaller
+    ids = [e[0] for e in entries]
+    if len(ids) > 254:
+        sys.exit("too many messages for 8-bit indices: %d" % len(ids))
+
+    low = [0] * low_size
+    high_ids = []
+    for pos, msgid in enumerate(ids):
+        if msgid < low_size:
+            low[msgid] = pos + 1
+        else:
+            high_ids.append((msgid, pos))
+
+    mult, bits = find_hash([m for m, _ in high_ids]) if high_ids else (1, 1)
+    high = [0] * (1 << bits)
+    for msgid, pos in high_ids:
+        high[hash_slot(msgid, mult, bits)] = pos + 1
+
+    rel = os.path.relpath(dialect, REPO).replace(os.sep, "/")
+    with open(output, "w") as f:
+        f.write("// Generated by scripts/gen_mavlink_msg_index.py from %s.\n" % rel)
+        if kept_names:
+            f.write("// Trimmed with --keep %s.\n" % ",".join(kept_names))
+        f.write("// Do not edit; rerun the script after changing the dialect.\n")
+        f.write("#pragma once\n\n")
+        f.write("#include <stdint.h>\n\n")
+        f.write("#define MAVLINK_MSG_INDEX_TRIMMED       %d\n" % (1 if kept_names else 0))
+        f.write("#define MAVLINK_MSG_INDEX_DIALECT_COUNT %du\n" % dialect_count)
+        f.write("#define MAVLINK_MSG_INDEX_COUNT         %du\n" % len(ids))
+        f.write("#define MAVLINK_MSG_INDEX_LOW_SIZE      %du\n" % low_size)
+        f.write("#define MAVLINK_MSG_INDEX_HASH_MULT     0x%08Xu\n" % mult)
+        f.write("#define MAVLINK_MSG_INDEX_HASH_BITS     %du\n\n" % bits)
+        if kept_names:
+            f.write("#define MAVLINK_MSG_INDEX_ENTRIES \\\n{ \\\n")
+            for i, e in enumerate(entries):
+                sep = "," if i + 1 < len(entries) else ""
+                f.write("    {%s}%s \\\n" % (", ".join(str(v) for v in e), sep))
+            f.write("}\n\n")
+        else:
+            f.write("#define MAVLINK_MSG_INDEX_ENTRIES MAVLINK_MESSAGE_CRCS\n\n")
+        if low_size > 0:
+            f.write("// msgid -> entry index + 1 (0 = unknown)\n")
+            f.write("static const uint8_t s_msg_index_low[MAVLINK_MSG_INDEX_LOW_SIZE] =\n{\n")
+            f.write(fmt_table(low, 16))
+            f.write("\n};\n\n")
+        f.write("// ((msgid * MULT) >> (32 - BITS)) -> entry index + 1 (0 = unknown)\n")
+        f.write("static const uint8_t s_msg_index_high[1u << MAVLINK_MSG_INDEX_HASH_BITS] =\n{\n")
+        f.write(fmt_table(high, 16))
+        f.write("\n};\n")
+
+    print("%s: %d of %d messages, %d hashed, hash mult=0x%08X bits=%d"
+          % (os.path.relpath(output, REPO), len(ids), dialect_count, len(high_ids), mult, bits))
+
+
+if __name__ == "__main__":
+    main()